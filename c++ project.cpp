@@ -1,26 +1,126 @@
 #include <bits/stdc++.h>
+#include <fcntl.h>
+#include <malloc.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 using namespace std;
 
+// ---------------- allocation tracking ----------------
+
+// Built with -DROADMAP_TRACK_ALLOC, every heap allocation is counted against
+// the category of the code that made it, set with a MemScope. A 16-byte
+// header in front of each block remembers its size and category so frees can
+// be attributed too; that header is extra memory per block, so the
+// replacement operator new is left out of normal builds and the MemScopes
+// then cost only a thread-local store.
+enum MemCategory { MemOther, MemDefinitions, MemCatalog, MemSteps, MemTermIndex, MemRelated, MemGraph, MemTenants, MemCategoryCount };
+const char *memCategoryNames[MemCategoryCount] = {
+    "other", "role definitions", "catalog", "step pool", "term index", "related index", "skill graph", "tenants"};
+
+struct MemCounters {
+    atomic<long long> live{0}, peak{0}, allocs{0}, frees{0}, overhead{0};
+};
+MemCounters memCounters[MemCategoryCount];
+thread_local int memCategory = MemOther;
+
+struct MemScope {
+    int saved;
+    explicit MemScope(int category) : saved(memCategory) { memCategory = category; }
+    ~MemScope() { memCategory = saved; }
+};
+
+struct alignas(16) AllocHeader {
+    size_t size;
+    int category;
+};
+
+#ifdef ROADMAP_TRACK_ALLOC
+const bool memTracking = true;
+
+// allocator slack: usable size beyond the request and the tracking header
+long long mallocSlack(void *raw, size_t n) {
+    return (long long)(malloc_usable_size(raw) - n - sizeof(AllocHeader));
+}
+
+void *trackedAlloc(size_t n) {
+    void *raw = malloc(n + sizeof(AllocHeader));
+    if (!raw) return nullptr;
+    AllocHeader *h = (AllocHeader *)raw;
+    h->size = n;
+    h->category = memCategory;
+    MemCounters &c = memCounters[h->category];
+    long long live = c.live += (long long)n;
+    for (long long p = c.peak; live > p && !c.peak.compare_exchange_weak(p, live);) {}
+    ++c.allocs;
+    c.overhead += mallocSlack(raw, n);
+    return h + 1;
+}
+
+void trackedFree(void *p) {
+    if (!p) return;
+    AllocHeader *h = (AllocHeader *)p - 1;
+    MemCounters &c = memCounters[h->category];
+    c.live -= (long long)h->size;
+    ++c.frees;
+    c.overhead -= mallocSlack(h, h->size);
+    free(h);
+}
+
+void *operator new(size_t n) {
+    if (void *p = trackedAlloc(n)) return p;
+    throw bad_alloc();
+}
+void *operator new[](size_t n) { return operator new(n); }
+void *operator new(size_t n, const nothrow_t &) noexcept { return trackedAlloc(n); }
+void *operator new[](size_t n, const nothrow_t &) noexcept { return trackedAlloc(n); }
+void operator delete(void *p) noexcept { trackedFree(p); }
+void operator delete[](void *p) noexcept { trackedFree(p); }
+void operator delete(void *p, size_t) noexcept { trackedFree(p); }
+void operator delete[](void *p, size_t) noexcept { trackedFree(p); }
+void operator delete(void *p, const nothrow_t &) noexcept { trackedFree(p); }
+void operator delete[](void *p, const nothrow_t &) noexcept { trackedFree(p); }
+#else
+const bool memTracking = false;
+#endif
+
 struct Phase {
     string title;
-    vector<string> steps;
+    vector<uint32_t> steps; // step IDs, see stepText()
 };
 
 struct Roadmap {
     string displayName;
     vector<Phase> phases;
+    string searchName; // normalize(displayName), filled in by the build pipeline
+    vector<string> prerequisites; // keys of roles assumed known before starting this one
 };
 
 // global map: normalized role -> roadmap
 unordered_map<string, Roadmap> roadmaps;
 
+// step texts shared by all roadmaps; near-duplicate steps are stored once
+vector<string> stepTexts;
+
+// steps only tenant deltas use, kept apart so the base pool stays as built;
+// their IDs carry the kTenantStep bit
+vector<string> tenantStepTexts;
+constexpr uint32_t kTenantStep = 1u << 31;
+
+const string &stepText(uint32_t id) {
+    return id & kTenantStep ? tenantStepTexts[id & ~kTenantStep] : stepTexts[id];
+}
+
 // helpers
+// per-character part of normalize(): lower-case, any whitespace becomes ' '
+char foldChar(char c) {
+    return isspace((unsigned char)c) ? ' ' : (char)tolower((unsigned char)c);
+}
+
 string normalize(const string &s) {
     string out;
-    for (char c : s) {
-        if (!isspace((unsigned char)c)) out.push_back(tolower((unsigned char)c));
-        else out.push_back(' ');
-    }
+    for (char c : s) out.push_back(foldChar(c));
     // trim
     while (!out.empty() && isspace((unsigned char)out.front())) out.erase(out.begin());
     while (!out.empty() && isspace((unsigned char)out.back())) out.pop_back();
@@ -35,55 +135,533 @@ string keyify(const string &s) {
     return k;
 }
 
-void printDivider() {
-    cout << "\n" << string(72, '=') << "\n\n";
+// 64-bit FNV-1a; pass a different basis to get an independent hash
+uint64_t hashBytes(const string &s, uint64_t h = 1469598103934665603ULL) {
+    for (unsigned char c : s) {
+        h ^= c;
+        h *= 1099511628211ULL;
+    }
+    return h;
 }
 
-void printRoadmap(const Roadmap &r) {
-    printDivider();
-    cout << "ROADMAP — " << r.displayName << "\n\n";
+void printDivider(ostream &out = cout) {
+    out << "\n" << string(72, '=') << "\n\n";
+}
+
+enum class Format { Text, Markdown, Html };
+
+// Aho-Corasick automaton over the normalize() form of a set of keywords.
+// Built once per query; scan() then finds every occurrence of every keyword
+// in a single pass over the text, however many keywords there are.
+struct KeywordMatcher {
+    vector<string> terms;           // normalized, de-duplicated
+    vector<array<int, 256>> next;   // full transition table (goto + failure folded in)
+    vector<vector<int>> out;        // terms ending at each state, including via suffix links
+
+    explicit KeywordMatcher(const vector<string> &words) {
+        for (auto &w : words) {
+            string t = normalize(w);
+            if (!t.empty() && find(terms.begin(), terms.end(), t) == terms.end()) terms.push_back(t);
+        }
+        next.emplace_back();
+        next[0].fill(-1);
+        out.emplace_back();
+        for (int ti = 0; ti < (int)terms.size(); ++ti) {
+            int st = 0;
+            for (unsigned char c : terms[ti]) {
+                if (next[st][c] < 0) {
+                    next[st][c] = (int)next.size();
+                    next.emplace_back();
+                    next.back().fill(-1);
+                    out.emplace_back();
+                }
+                st = next[st][c];
+            }
+            out[st].push_back(ti);
+        }
+
+        // breadth-first: resolve missing transitions through the failure link
+        vector<int> fail(next.size(), 0);
+        queue<int> q;
+        for (int c = 0; c < 256; ++c) {
+            int &t = next[0][c];
+            if (t < 0) t = 0;
+            else q.push(t);
+        }
+        while (!q.empty()) {
+            int st = q.front();
+            q.pop();
+            const vector<int> &inherited = out[fail[st]];
+            out[st].insert(out[st].end(), inherited.begin(), inherited.end());
+            for (int c = 0; c < 256; ++c) {
+                int &t = next[st][c];
+                if (t < 0) {
+                    t = next[fail[st]][c];
+                } else {
+                    fail[t] = next[fail[st]][c];
+                    q.push(t);
+                }
+            }
+        }
+    }
+
+    bool empty() const { return terms.empty(); }
+
+    // Same word rule as tokenize(): letters and digits, plus '+' and '#'
+    // after them ("c++", "c#"). A hit must not extend into a longer word.
+    static bool wholeWord(const string &text, size_t b, size_t e) {
+        auto alnum = [&](size_t i) { return isalnum((unsigned char)text[i]) != 0; };
+        if (b > 0 && alnum(b) && alnum(b - 1)) return false;
+        if (e < text.size() && alnum(e - 1) && (alnum(e) || text[e] == '+' || text[e] == '#')) return false;
+        return true;
+    }
+
+    // calls onMatch(begin, end, termIndex) for every whole-word occurrence in text
+    template <class F>
+    void scan(const string &text, F onMatch) const {
+        int st = 0;
+        for (size_t i = 0; i < text.size(); ++i) {
+            st = next[st][(unsigned char)foldChar(text[i])];
+            for (int ti : out[st]) {
+                size_t b = i + 1 - terms[ti].size();
+                if (wholeWord(text, b, i + 1)) onMatch(b, i + 1, ti);
+            }
+        }
+    }
+};
+
+// the keywords of the last 'find' query, highlighted when roadmaps are shown
+unique_ptr<KeywordMatcher> activeHighlight;
+
+string htmlEscape(const string &s) {
+    string out;
+    out.reserve(s.size());
+    for (char c : s) {
+        switch (c) {
+            case '&': out += "&amp;"; break;
+            case '<': out += "&lt;"; break;
+            case '>': out += "&gt;"; break;
+            case '"': out += "&quot;"; break;
+            default: out.push_back(c);
+        }
+    }
+    return out;
+}
+
+// Writes one step, wrapping keyword hits in format-specific markers and adding
+// them to hits (one counter per term). Overlapping hits are merged.
+void renderStep(ostream &out, const string &s, Format f, const KeywordMatcher *hl, vector<int> *hits) {
+    auto plain = [&](const string &t) { out << (f == Format::Html ? htmlEscape(t) : t); };
+    if (!hl) {
+        plain(s);
+        return;
+    }
+    vector<pair<size_t, size_t>> spans;
+    hl->scan(s, [&](size_t b, size_t e, int ti) {
+        if (hits) ++(*hits)[ti];
+        spans.push_back({b, e});
+    });
+    sort(spans.begin(), spans.end());
+    const char *open = f == Format::Html ? "<mark>" : f == Format::Markdown ? "**" : "[[";
+    const char *close = f == Format::Html ? "</mark>" : f == Format::Markdown ? "**" : "]]";
+    size_t pos = 0;
+    for (size_t i = 0; i < spans.size();) {
+        size_t b = spans[i].first, e = spans[i].second;
+        for (++i; i < spans.size() && spans[i].first <= e; ++i) e = max(e, spans[i].second);
+        plain(s.substr(pos, b - pos));
+        out << open;
+        plain(s.substr(b, e - b));
+        out << close;
+        pos = e;
+    }
+    plain(s.substr(pos));
+}
+
+// "kafka 2, spark 1" for the terms that were hit at least once
+string hitSummary(const KeywordMatcher &hl, const vector<int> &hits) {
+    string out;
+    for (size_t i = 0; i < hits.size(); ++i) {
+        if (!hits[i]) continue;
+        if (!out.empty()) out += ", ";
+        out += hl.terms[i] + " " + to_string(hits[i]);
+    }
+    return out;
+}
+
+void renderRoadmap(ostream &out, const Roadmap &r, Format f, const KeywordMatcher *hl = nullptr) {
+    vector<int> hits(hl ? hl->terms.size() : 0, 0);
+    auto hitLine = [&]() {
+        int total = accumulate(hits.begin(), hits.end(), 0);
+        return to_string(total) + " keyword hit" + (total == 1 ? "" : "s") + (total ? ": " + hitSummary(*hl, hits) : "");
+    };
+
+    if (f == Format::Markdown) {
+        out << "# " << r.displayName << "\n\n";
+        int pidx = 1;
+        for (auto &p : r.phases) {
+            out << "## Phase " << pidx++ << " — " << p.title << "\n\n";
+            int sidx = 1;
+            for (uint32_t id : p.steps) {
+                out << sidx++ << ". ";
+                renderStep(out, stepText(id), f, hl, &hits);
+                out << "\n";
+            }
+            out << "\n";
+        }
+        if (hl) out << "_" << hitLine() << "_\n";
+        return;
+    }
+    if (f == Format::Html) {
+        out << "<!DOCTYPE html>\n<html><head><meta charset=\"utf-8\"><title>"
+            << htmlEscape(r.displayName) << " roadmap</title></head>\n<body>\n"
+            << "<p><a href=\"index.html\">All roadmaps</a></p>\n"
+            << "<h1>" << htmlEscape(r.displayName) << "</h1>\n";
+        int pidx = 1;
+        for (auto &p : r.phases) {
+            out << "<h2>Phase " << pidx++ << " — " << htmlEscape(p.title) << "</h2>\n<ol>\n";
+            for (uint32_t id : p.steps) {
+                out << "<li>";
+                renderStep(out, stepText(id), f, hl, &hits);
+                out << "</li>\n";
+            }
+            out << "</ol>\n";
+        }
+        if (hl) out << "<p><em>" << htmlEscape(hitLine()) << "</em></p>\n";
+        out << "</body></html>\n";
+        return;
+    }
+
+    printDivider(out);
+    out << "ROADMAP — " << r.displayName << "\n\n";
     int pidx = 1;
     for (auto &p : r.phases) {
-        cout << "PHASE " << pidx++ << " — " << p.title << "\n";
-        cout << string(40, '-') << "\n";
+        out << "PHASE " << pidx++ << " — " << p.title << "\n";
+        out << string(40, '-') << "\n";
         int sidx = 1;
-        for (auto &s : p.steps) {
-            cout << sidx++ << ". " << s << "\n";
+        for (uint32_t id : p.steps) {
+            out << sidx++ << ". ";
+            renderStep(out, stepText(id), f, hl, &hits);
+            out << "\n";
         }
-        cout << "\n";
+        out << "\n";
     }
-    printDivider();
+    if (hl) out << hitLine() << "\n";
+    printDivider(out);
 }
 
-// find best matching roles (exact or substring)
-vector<string> findMatches(const string &input) {
+void printRoadmap(const Roadmap &r) {
+    renderRoadmap(cout, r, Format::Text, activeHighlight.get());
+}
+
+// find best matching roles (exact or substring) among the roles that
+// forEachRole(fn) visits as fn(key, roadmap)
+template <class ForEachRole>
+vector<string> matchRoles(const string &input, ForEachRole forEachRole) {
     string in = keyify(input);
     vector<string> exacts;
     vector<string> substrs;
-    for (auto &kv : roadmaps) {
-        string k = kv.first; // already keyified
-        if (k == in) exacts.push_back(kv.first);
-        else if (k.find(in) != string::npos) substrs.push_back(kv.first);
-    }
+    forEachRole([&](const string &k, const Roadmap &) { // k is already keyified
+        if (k == in) exacts.push_back(k);
+        else if (k.find(in) != string::npos) substrs.push_back(k);
+    });
     if (!exacts.empty()) return exacts;
     if (!substrs.empty()) return substrs;
 
     // fallback: find roles whose displayName contains input (case-insensitive)
     vector<string> fallback;
     string lowered = normalize(input);
-    for (auto &kv : roadmaps) {
-        string dn = normalize(kv.second.displayName);
-        if (dn.find(lowered) != string::npos) fallback.push_back(kv.first);
-    }
+    forEachRole([&](const string &k, const Roadmap &r) {
+        if (r.searchName.find(lowered) != string::npos) fallback.push_back(k);
+    });
     return fallback;
 }
 
-void initRoadmaps() {
+vector<string> findMatches(const string &input) {
+    return matchRoles(input, [](auto fn) {
+        for (auto &kv : roadmaps) fn(kv.first, kv.second);
+    });
+}
+
+// upper bound on parallelFor threads; 0 = one per hardware thread
+size_t threadLimit = 0;
+
+// run fn(begin, end) over [0, n) split into contiguous ranges, one per thread.
+// Small inputs stay on the calling thread; spawning threads costs more than it saves.
+template <class F>
+void parallelFor(size_t n, F fn, size_t minPerThread = 64) {
+    size_t hw = threadLimit ? threadLimit : max<size_t>(1, thread::hardware_concurrency());
+    size_t threads = min(hw, max<size_t>(1, n / minPerThread));
+    if (threads <= 1) {
+        fn(size_t(0), n);
+        return;
+    }
+    vector<thread> pool;
+    size_t chunk = (n + threads - 1) / threads;
+    int category = memCategory; // workers allocate on behalf of the caller
+    for (size_t b = 0; b < n; b += chunk) {
+        size_t e = min(n, b + chunk);
+        pool.emplace_back([&fn, b, e, category] {
+            MemScope scope(category);
+            fn(b, e);
+        });
+    }
+    for (auto &t : pool) t.join();
+}
+
+// role definition as written in initRoadmaps() (or read from an external catalog)
+struct PhaseDef {
+    string title;
+    vector<string> steps;
+};
+
+struct RoleDef {
+    string name;
+    vector<PhaseDef> phases;
+    vector<string> prerequisites; // role names
+};
+
+// ---------------- step deduplication (MinHash + LSH) ----------------
+
+// Each step is reduced to a MinHash signature over character 5-grams of its
+// letters and digits. Signatures are split into kBands bands of kRows rows;
+// steps sharing any band land in the same LSH bucket and become candidates,
+// which are accepted when their signatures agree on at least
+// kMinSimilarity of the rows (an estimate of Jaccard similarity).
+//
+// Merged steps are shown with the canonical text, so the threshold only
+// admits rewordings that keep the content. Paraphrases that differ in detail
+// (the closest cross-role pairs in the built-in catalog score 0.18-0.28)
+// stay separate: at that level unrelated steps collide as well.
+//
+// The band hashes of stored steps are kept so later builds (imports) reuse a
+// step already in the pool; candidate signatures are recomputed from the
+// stored text rather than kept.
+struct StepDedup {
+    static constexpr int kBands = 16, kRows = 4, kHashes = kBands * kRows;
+    static constexpr double kMinSimilarity = 0.8;
+    static constexpr size_t kSample = 10;
+
+    // totals over all builds
+    size_t inputSteps = 0, storedSteps = 0, mergedSteps = 0, inputBytes = 0, storedBytes = 0;
+    vector<pair<string, uint32_t>> sample; // first few near-duplicates (not identical) -> step they were folded into
+
+    vector<uint64_t> poolBands; // (band key << 32) | step ID for every stored step, sorted
+
+    static uint64_t mix(uint64_t x) { // splitmix64 finalizer
+        x ^= x >> 30;
+        x *= 0xbf58476d1ce4e5b9ULL;
+        x ^= x >> 27;
+        x *= 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+
+    static array<uint64_t, kHashes> signature(const string &text) {
+        string t;
+        for (char c : text)
+            if (isalnum((unsigned char)c)) t.push_back((char)tolower((unsigned char)c));
+        array<uint64_t, kHashes> sig;
+        sig.fill(~0ULL);
+        size_t k = min<size_t>(5, t.size());
+        for (size_t i = 0; i + k <= t.size(); ++i) {
+            uint64_t h = hashBytes(t.substr(i, k));
+            for (int j = 0; j < kHashes; ++j) sig[j] = min(sig[j], mix(h + 0x9e3779b97f4a7c15ULL * (j + 1)));
+        }
+        return sig;
+    }
+
+    static uint32_t bandKey(const array<uint64_t, kHashes> &sig, int band) {
+        uint64_t h = band;
+        for (int r = 0; r < kRows; ++r) h = mix(h ^ sig[band * kRows + r]);
+        return (uint32_t)(h >> 32);
+    }
+
+    static bool similar(const array<uint64_t, kHashes> &a, const array<uint64_t, kHashes> &b) {
+        int same = 0;
+        for (int x = 0; x < kHashes; ++x) same += a[x] == b[x];
+        return same >= kMinSimilarity * kHashes;
+    }
+
+    // stored step whose text is exactly text, or UINT32_MAX; identical texts
+    // share every band, so the candidates of one band are enough
+    uint32_t findExact(const string &text) const {
+        uint64_t key = (uint64_t)bandKey(signature(text), 0) << 32;
+        for (auto it = lower_bound(poolBands.begin(), poolBands.end(), key); it != poolBands.end() && (*it >> 32) == key >> 32; ++it)
+            if (stepTexts[(uint32_t)*it] == text) return (uint32_t)*it;
+        return UINT32_MAX;
+    }
+
+    // lowest stored step similar to sig, or UINT32_MAX
+    uint32_t probePool(const array<uint64_t, kHashes> &sig) const {
+        uint32_t best = UINT32_MAX;
+        for (int band = 0; band < kBands; ++band) {
+            uint64_t key = (uint64_t)bandKey(sig, band) << 32;
+            for (auto it = lower_bound(poolBands.begin(), poolBands.end(), key); it != poolBands.end() && (*it >> 32) == key >> 32; ++it) {
+                uint32_t id = (uint32_t)*it;
+                if (id < best && similar(sig, signature(stepTexts[id]))) best = id;
+            }
+        }
+        return best;
+    }
+
+    // Returns the stepTexts index for each input text. Texts are visited in
+    // order and each cluster keeps its first member as the canonical text,
+    // unless a member matches a step already stored, so the result is
+    // deterministic.
+    vector<uint32_t> run(vector<string> &texts) {
+        MemScope scope(MemSteps);
+        size_t n = texts.size();
+        vector<array<uint64_t, kHashes>> sigs(n);
+        vector<uint32_t> inPool(n, UINT32_MAX);
+        parallelFor(n, [&](size_t b, size_t e) {
+            for (size_t i = b; i < e; ++i) {
+                sigs[i] = signature(texts[i]);
+                if (!poolBands.empty()) inPool[i] = probePool(sigs[i]);
+            }
+        });
+
+        // Union-find towards the earliest member, one per band so the bands
+        // run in parallel; the band forests are then merged into the first.
+        // Each band's result depends only on that band, so the clusters do
+        // not depend on the thread count.
+        vector<vector<uint32_t>> parents(kBands, vector<uint32_t>(n));
+        auto rootIn = [](vector<uint32_t> &parent, uint32_t x) {
+            while (parent[x] != x) x = parent[x] = parent[parent[x]];
+            return x;
+        };
+        parallelFor(kBands, [&](size_t bandBegin, size_t bandEnd) {
+            for (size_t band = bandBegin; band < bandEnd; ++band) {
+                vector<uint32_t> &parent = parents[band];
+                iota(parent.begin(), parent.end(), 0);
+                // one member of every cluster seen in each bucket, so a false
+                // collision with the first member does not hide later matches
+                unordered_map<uint32_t, vector<uint32_t>> buckets;
+                for (uint32_t i = 0; i < n; ++i) {
+                    vector<uint32_t> &members = buckets[bandKey(sigs[i], (int)band)];
+                    bool joined = false;
+                    for (uint32_t j : members) {
+                        uint32_t a = rootIn(parent, i), b = rootIn(parent, j);
+                        if (a != b && similar(sigs[i], sigs[j])) parent[max(a, b)] = min(a, b);
+                        joined |= rootIn(parent, i) == rootIn(parent, j);
+                    }
+                    if (!joined) members.push_back(i);
+                }
+            }
+        });
+        vector<uint32_t> &parent = parents[0];
+        auto root = [&](uint32_t x) { return rootIn(parent, x); };
+        for (int band = 1; band < kBands; ++band) {
+            for (uint32_t i = 0; i < n; ++i) {
+                uint32_t a = root(i), b = root(rootIn(parents[band], i));
+                if (a != b) parent[max(a, b)] = min(a, b);
+            }
+            vector<uint32_t>().swap(parents[band]);
+        }
+
+        vector<uint32_t> ids(n), idOfRoot(n, UINT32_MAX), poolOfRoot(n, UINT32_MAX);
+        for (uint32_t i = 0; i < n; ++i) poolOfRoot[root(i)] = min(poolOfRoot[root(i)], inPool[i]);
+        size_t firstNew = poolBands.size();
+        for (uint32_t i = 0; i < n; ++i) {
+            inputSteps++;
+            inputBytes += texts[i].size();
+            uint32_t r = root(i);
+            bool stored = false;
+            if (idOfRoot[r] == UINT32_MAX && poolOfRoot[r] != UINT32_MAX) {
+                idOfRoot[r] = poolOfRoot[r];
+            } else if (idOfRoot[r] == UINT32_MAX) {
+                idOfRoot[r] = (uint32_t)stepTexts.size();
+                storedSteps++;
+                storedBytes += texts[i].size();
+                for (int band = 0; band < kBands; ++band)
+                    poolBands.push_back((uint64_t)bandKey(sigs[i], band) << 32 | idOfRoot[r]);
+                // a moved string stays charged to the stage that allocated it
+                // (role definitions); copy it so the tracked build charges
+                // the pool
+                stepTexts.push_back(memTracking ? string(texts[i]) : move(texts[i]));
+                stored = true;
+            }
+            if (!stored && texts[i] != stepTexts[idOfRoot[r]]) {
+                mergedSteps++;
+                if (sample.size() < kSample) sample.push_back({move(texts[i]), idOfRoot[r]});
+            }
+            ids[i] = idOfRoot[r];
+        }
+        sort(poolBands.begin() + firstNew, poolBands.end());
+        inplace_merge(poolBands.begin(), poolBands.begin() + firstNew, poolBands.end());
+        poolBands.shrink_to_fit(); // kept for the life of the catalog
+        return ids;
+    }
+};
+
+StepDedup stepDedup;
+
+void buildIndexes(const vector<string> &changedKeys); // defined with the indexes, after initRoadmaps()
+
+// wall time of each stage of the last buildCatalog(), in milliseconds
+struct BuildTimings {
+    double prepare = 0, dedup = 0, merge = 0, indexes = 0;
+} buildTimings;
+
+double msSince(chrono::steady_clock::time_point t0) {
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+}
+
+// Build pipeline: definitions -> keyify/normalize (parallel, per role range)
+// -> step deduplication -> merge into the global map -> indexes. The merge
+// walks definitions in their original order, so the result does not depend
+// on the thread count and a later definition of the same key still replaces
+// an earlier one.
+void buildCatalog(vector<RoleDef> &defs) {
+    MemScope scope(MemCatalog);
+    auto t0 = chrono::steady_clock::now();
+    size_t n = defs.size();
+    vector<string> keys(n);
+    vector<Roadmap> built(n);
+    parallelFor(n, [&](size_t b, size_t e) {
+        for (size_t i = b; i < e; ++i) {
+            keys[i] = keyify(defs[i].name);
+            built[i].searchName = normalize(defs[i].name);
+            built[i].displayName = move(defs[i].name);
+            for (auto &pre : defs[i].prerequisites) built[i].prerequisites.push_back(keyify(pre));
+        }
+    });
+    buildTimings.prepare = msSince(t0);
+
+    t0 = chrono::steady_clock::now();
+    vector<string> texts;
+    for (auto &d : defs)
+        for (auto &p : d.phases)
+            for (auto &st : p.steps) texts.push_back(move(st));
+    vector<uint32_t> ids = stepDedup.run(texts);
+    size_t next = 0;
+    for (size_t i = 0; i < n; ++i) {
+        for (auto &p : defs[i].phases) {
+            Phase ph{move(p.title), {}};
+            ph.steps.assign(ids.begin() + next, ids.begin() + next + p.steps.size());
+            next += p.steps.size();
+            built[i].phases.push_back(move(ph));
+        }
+    }
+    buildTimings.dedup = msSince(t0);
+
+    t0 = chrono::steady_clock::now();
+    roadmaps.reserve(roadmaps.size() + n);
+    for (size_t i = 0; i < n; ++i) roadmaps[keys[i]] = move(built[i]);
+    defs.clear();
+    buildTimings.merge = msSince(t0);
+
+    t0 = chrono::steady_clock::now();
+    buildIndexes(keys);
+    buildTimings.indexes = msSince(t0);
+}
+
+vector<RoleDef> builtinRoles() {
     // For each role we create a Roadmap with several phases and many detailed steps.
     // Keys are 'keyified' (all letters lower and no spaces) to make matching robust.
-    auto add = [&](const string &name, const vector<Phase> &phs) {
-        string key = keyify(name);
-        roadmaps[key] = Roadmap{name, phs};
+    // Definitions are collected here and handed to buildCatalog() in one batch.
+    MemScope scope(MemDefinitions);
+    vector<RoleDef> defs;
+    auto add = [&](const string &name, const vector<PhaseDef> &phs) {
+        defs.push_back(RoleDef{name, phs, {}});
     };
 
     // FRONTEND
@@ -807,78 +1385,2115 @@ void initRoadmaps() {
     });
 
     // End of definitions
+
+    // Role-level prerequisites: the first phase of a role builds on these.
+    auto prerequisite = [&](const string &name, const vector<string> &roles) {
+        for (auto &d : defs)
+            if (d.name == name) d.prerequisites = roles;
+    };
+    prerequisite("Full Stack", {"Frontend", "Backend"});
+    prerequisite("DevOps", {"Backend"});
+    prerequisite("Software Architect", {"Backend"});
+    prerequisite("Engineering Manager", {"Software Architect"});
+    prerequisite("Data Engineer", {"Backend", "PostgreSQL"});
+    prerequisite("Machine Learning", {"Data Analyst"});
+    prerequisite("AI and Data Scientist", {"Data Analyst"});
+    prerequisite("BI Analyst", {"Data Analyst"});
+    prerequisite("AI Engineer", {"Machine Learning"});
+    prerequisite("MLOps", {"Machine Learning", "DevOps"});
+    prerequisite("Server Side Game Developer", {"Game Developer", "Backend"});
+
+    return defs;
 }
 
+void initRoadmaps() {
+    vector<RoleDef> defs = builtinRoles();
+    buildCatalog(defs);
+}
 
-int main() {
-    ios::sync_with_stdio(false);
-    cin.tie(nullptr);
+vector<string> splitWords(const string &s) {
+    vector<string> out;
+    istringstream in(s);
+    string w;
+    while (in >> w) out.push_back(w);
+    return out;
+}
 
-    initRoadmaps();
+// the part of line after its first n words, original spacing kept
+string restOf(const string &line, size_t n) {
+    size_t pos = line.find_first_not_of(" \t");
+    for (size_t i = 0; i < n && pos != string::npos; ++i) {
+        pos = line.find_first_of(" \t", pos);
+        if (pos != string::npos) pos = line.find_first_not_of(" \t", pos);
+    }
+    return pos == string::npos ? "" : line.substr(pos);
+}
 
-    // Print welcome banner with endl for flush
-    cout << "============================================================" << endl;
-    cout << "              ROLE-BASED ROADMAP SEARCH SYSTEM" << endl;
-    cout << "============================================================" << endl << endl;
+// keys in a fixed order, so anything built from them is reproducible
+vector<string> sortedKeys() {
+    vector<string> keys;
+    keys.reserve(roadmaps.size());
+    for (auto &kv : roadmaps) keys.push_back(kv.first);
+    sort(keys.begin(), keys.end());
+    return keys;
+}
 
-    cout << "Available Roles:" << endl;
-    cout << "------------------------------------------------------------" << endl;
-    for (auto &kv : roadmaps) {
-        cout << kv.second.displayName << endl;
+// lower-cased words of a text: runs of letters/digits, keeping '+' and '#'
+// so that "C++" and "C#" survive as terms
+vector<string> tokenize(const string &s) {
+    vector<string> out;
+    string cur;
+    for (char c : s) {
+        if (isalnum((unsigned char)c) || ((c == '+' || c == '#') && !cur.empty())) {
+            cur.push_back((char)tolower((unsigned char)c));
+        } else if (!cur.empty()) {
+            out.push_back(move(cur));
+            cur.clear();
+        }
     }
-    cout << "------------------------------------------------------------" << endl;
-    cout << "Type any role name to view its FULL roadmap." << endl;
-    cout << "(To exit, type: exit)" << endl << endl;
+    if (!cur.empty()) out.push_back(move(cur));
+    return out;
+}
 
-    while (true) {
-        cout << "\nEnter role: " << flush;  // flush ensures prompt is visible immediately
-        string line;
-        if (!getline(cin, line)) break;
+// ---------------- role bitmaps and boolean filters ----------------
 
-        // trim input
-        while (!line.empty() && isspace((unsigned char)line.front())) line.erase(line.begin());
-        while (!line.empty() && isspace((unsigned char)line.back())) line.pop_back();
-        if (line.empty()) continue;
+// Compressed set of role IDs, roaring-style: IDs are split by their high 16
+// bits into containers; a container is a sorted uint16 array while sparse and
+// a 65536-bit bitset once it holds more than kArrayMax values.
+struct RoleBitmap {
+    static constexpr size_t kArrayMax = 4096;
+    static constexpr size_t kWords = 65536 / 64;
 
-        string lower = normalize(line);
-        if (lower == "exit" || lower == "quit") {
-            cout << "Bye." << endl;
-            break;
+    struct Container {
+        uint16_t high = 0;
+        vector<uint16_t> array;
+        vector<uint64_t> bits; // empty unless this is a bitset container
+
+        bool isBitset() const { return !bits.empty(); }
+        size_t cardinality() const {
+            if (!isBitset()) return array.size();
+            size_t c = 0;
+            for (uint64_t w : bits) c += __builtin_popcountll(w);
+            return c;
         }
+        void toBitset() {
+            bits.assign(kWords, 0);
+            for (uint16_t v : array) bits[v >> 6] |= 1ULL << (v & 63);
+            array.clear();
+            array.shrink_to_fit();
+        }
+        // back to an array if the result of an operation became sparse
+        void shrink() {
+            if (!isBitset() || cardinality() > kArrayMax) return;
+            for (size_t w = 0; w < kWords; ++w)
+                for (uint64_t b = bits[w]; b; b &= b - 1) array.push_back(uint16_t(w * 64 + __builtin_ctzll(b)));
+            bits.clear();
+            bits.shrink_to_fit();
+        }
+        bool empty() const { return isBitset() ? cardinality() == 0 : array.empty(); }
+    };
 
-        if (lower == "list") {
-            cout << "\nSupported roles:" << endl;
-            vector<string> names;
-            for (auto &kv : roadmaps) names.push_back(kv.second.displayName);
-            sort(names.begin(), names.end());
-            for (auto &n : names) cout << " - " << n << endl;
-            continue;
+    vector<Container> chunks; // sorted by high
+
+    void add(uint32_t id) {
+        uint16_t high = uint16_t(id >> 16), low = uint16_t(id & 0xFFFF);
+        auto it = lower_bound(chunks.begin(), chunks.end(), high,
+                              [](const Container &c, uint16_t h) { return c.high < h; });
+        if (it == chunks.end() || it->high != high) {
+            it = chunks.insert(it, Container{});
+            it->high = high;
         }
+        if (it->isBitset()) {
+            it->bits[low >> 6] |= 1ULL << (low & 63);
+            return;
+        }
+        auto pos = lower_bound(it->array.begin(), it->array.end(), low);
+        if (pos != it->array.end() && *pos == low) return;
+        it->array.insert(pos, low);
+        if (it->array.size() > kArrayMax) it->toBitset();
+    }
 
-        vector<string> matches = findMatches(line);
-        if (matches.empty()) {
-            cout << "No roadmap found for '" << line << "'. Try 'list' to see supported roles or type a substring." << endl;
-            continue;
+    size_t cardinality() const {
+        size_t c = 0;
+        for (auto &ch : chunks) c += ch.cardinality();
+        return c;
+    }
+
+    template <class F>
+    void forEach(F fn) const {
+        for (auto &ch : chunks) {
+            uint32_t base = uint32_t(ch.high) << 16;
+            if (!ch.isBitset()) {
+                for (uint16_t v : ch.array) fn(base | v);
+            } else {
+                for (size_t w = 0; w < kWords; ++w)
+                    for (uint64_t b = ch.bits[w]; b; b &= b - 1) fn(base | uint32_t(w * 64 + __builtin_ctzll(b)));
+            }
         }
+    }
 
-        if (matches.size() > 1) {
-            cout << "\nMultiple matches found. Please choose:" << endl;
-            for (size_t i = 0; i < matches.size(); ++i)
-                cout << i + 1 << ") " << roadmaps[matches[i]].displayName << endl;
-            cout << "Enter number (or 0 to cancel): " << flush;
+    enum class Op { And, Or, AndNot };
 
-            string numLine;
-            if (!getline(cin, numLine)) break;
-            int choice = 0;
-            try { choice = stoi(numLine); } catch (...) { choice = 0; }
-            if (choice <= 0 || choice > (int)matches.size()) {
-                cout << "Cancelled." << endl;
-                continue;
+    // Container-level operation. Two arrays are merged directly; anything
+    // involving a bitset runs as a plain word loop, which the compiler
+    // vectorizes. An array AND a bitset (either way round) or an array
+    // AND NOT a bitset just probes the bitset.
+    static Container combine(const Container &a, const Container &b, Op op) {
+        if (op == Op::And && a.isBitset() && !b.isBitset()) return combine(b, a, op);
+        Container r;
+        r.high = a.high;
+        if (!a.isBitset() && !b.isBitset()) {
+            auto out = back_inserter(r.array);
+            if (op == Op::And) set_intersection(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(), out);
+            else if (op == Op::Or) set_union(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(), out);
+            else set_difference(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(), out);
+            if (r.array.size() > kArrayMax) r.toBitset();
+            return r;
+        }
+        if (op != Op::Or && !a.isBitset()) {
+            bool keep = op == Op::And;
+            for (uint16_t v : a.array)
+                if (((b.bits[v >> 6] >> (v & 63)) & 1) == keep) r.array.push_back(v);
+            return r;
+        }
+        Container ba = a, bb = b;
+        if (!ba.isBitset()) ba.toBitset();
+        if (!bb.isBitset()) bb.toBitset();
+        r.bits.resize(kWords);
+        const uint64_t *x = ba.bits.data(), *y = bb.bits.data();
+        uint64_t *z = r.bits.data();
+        if (op == Op::And) for (size_t w = 0; w < kWords; ++w) z[w] = x[w] & y[w];
+        else if (op == Op::Or) for (size_t w = 0; w < kWords; ++w) z[w] = x[w] | y[w];
+        else for (size_t w = 0; w < kWords; ++w) z[w] = x[w] & ~y[w];
+        r.shrink();
+        return r;
+    }
+
+    static RoleBitmap combine(const RoleBitmap &a, const RoleBitmap &b, Op op) {
+        RoleBitmap r;
+        size_t i = 0, j = 0;
+        while (i < a.chunks.size() || j < b.chunks.size()) {
+            bool hasA = i < a.chunks.size(), hasB = j < b.chunks.size();
+            if (hasA && (!hasB || a.chunks[i].high < b.chunks[j].high)) {
+                if (op != Op::And) r.chunks.push_back(a.chunks[i]);
+                ++i;
+            } else if (hasB && (!hasA || b.chunks[j].high < a.chunks[i].high)) {
+                if (op == Op::Or) r.chunks.push_back(b.chunks[j]);
+                ++j;
+            } else {
+                Container c = combine(a.chunks[i++], b.chunks[j++], op);
+                if (!c.empty()) r.chunks.push_back(move(c));
             }
-            printRoadmap(roadmaps[matches[choice - 1]]);
-        } else {
-            printRoadmap(roadmaps[matches[0]]);
         }
+        return r;
+    }
+};
+
+// role IDs are positions in roleKeys (sorted keys at build time)
+vector<string> roleKeys;
+RoleBitmap allRoles;
+// word -> roles whose phase titles or steps contain it;
+// "title:<word>" -> roles with a phase title containing it
+unordered_map<string, RoleBitmap> termIndex;
+
+// all terms and title tags of one roadmap, sorted and unique
+vector<string> roleTerms(const Roadmap &r) {
+    vector<string> terms;
+    for (auto &p : r.phases) {
+        for (auto &w : tokenize(p.title)) {
+            terms.push_back("title:" + w);
+            terms.push_back(w);
+        }
+        for (uint32_t id : p.steps)
+            for (auto &w : tokenize(stepText(id))) terms.push_back(w);
+    }
+    sort(terms.begin(), terms.end());
+    terms.erase(unique(terms.begin(), terms.end()), terms.end());
+    return terms;
+}
+
+void buildTermIndex() {
+    MemScope scope(MemTermIndex);
+    roleKeys = sortedKeys();
+    vector<vector<string>> terms(roleKeys.size());
+    parallelFor(roleKeys.size(), [&](size_t b, size_t e) {
+        for (size_t i = b; i < e; ++i) terms[i] = roleTerms(roadmaps.at(roleKeys[i]));
+    });
+    termIndex.clear();
+    allRoles = RoleBitmap{};
+    for (uint32_t id = 0; id < roleKeys.size(); ++id) {
+        allRoles.add(id);
+        for (auto &t : terms[id]) termIndex[t].add(id); // IDs arrive in order: appends only
+    }
+}
+
+// Recursive-descent evaluation of a filter expression:
+//   expr := and ('OR' and)*     and := unary (['AND'] unary)*
+//   unary := 'NOT' unary | '(' expr ')' | term
+// Adjacent terms without an operator are ANDed. A term is a word or
+// title:<word>; a term that tokenizes into several words (e.g. "ci/cd")
+// requires all of them.
+struct FilterParser {
+    vector<string> toks;
+    size_t pos = 0;
+    string error;
+    // the roles and postings to evaluate against; the base catalog by default
+    const RoleBitmap *universe = &allRoles;
+    function<const RoleBitmap *(const string &)> posting = [](const string &term) {
+        auto it = termIndex.find(term);
+        return it == termIndex.end() ? nullptr : &it->second;
+    };
+
+    explicit FilterParser(const string &text) {
+        string spaced;
+        for (char c : text) {
+            if (c == '(' || c == ')') spaced += string(" ") + c + " ";
+            else spaced.push_back(c);
+        }
+        toks = splitWords(spaced);
+    }
+
+    bool atKeyword(const char *kw) const { return pos < toks.size() && normalize(toks[pos]) == kw; }
+
+    RoleBitmap parseExpr() {
+        RoleBitmap r = parseAnd();
+        while (atKeyword("or")) {
+            ++pos;
+            r = RoleBitmap::combine(r, parseAnd(), RoleBitmap::Op::Or);
+        }
+        return r;
+    }
+
+    RoleBitmap parseAnd() {
+        RoleBitmap r = parseUnary();
+        while (pos < toks.size() && !atKeyword("or") && toks[pos] != ")") {
+            if (atKeyword("and")) ++pos;
+            r = RoleBitmap::combine(r, parseUnary(), RoleBitmap::Op::And);
+        }
+        return r;
+    }
+
+    RoleBitmap parseUnary() {
+        if (pos >= toks.size()) {
+            if (error.empty()) error = "expression ends too early";
+            return {};
+        }
+        if (atKeyword("not")) {
+            ++pos;
+            return RoleBitmap::combine(*universe, parseUnary(), RoleBitmap::Op::AndNot);
+        }
+        if (toks[pos] == "(") {
+            ++pos;
+            RoleBitmap r = parseExpr();
+            if (pos < toks.size() && toks[pos] == ")") ++pos;
+            else if (error.empty()) error = "missing ')'";
+            return r;
+        }
+        if (toks[pos] == ")" || atKeyword("and")) {
+            if (error.empty()) error = "unexpected '" + toks[pos] + "'";
+            ++pos;
+            return {};
+        }
+        return lookupTerm(toks[pos++]);
+    }
+
+    RoleBitmap lookupTerm(const string &term) const {
+        string t = normalize(term), prefix;
+        if (t.rfind("title:", 0) == 0) {
+            prefix = "title:";
+            t = t.substr(prefix.size());
+        }
+        vector<string> words = tokenize(t);
+        if (words.empty()) return {};
+        RoleBitmap r = *universe;
+        for (auto &w : words) {
+            const RoleBitmap *bm = posting(prefix + w);
+            if (!bm) return {};
+            r = RoleBitmap::combine(r, *bm, RoleBitmap::Op::And);
+        }
+        return r;
+    }
+};
+
+// ---------------- static-site export ----------------
+
+string pageExtension(Format f) {
+    return f == Format::Html ? ".html" : ".md";
+}
+
+string indexPageName(Format f) {
+    return "index" + pageExtension(f);
+}
+
+// true for names pageNames() can produce: [A-Za-z0-9_-] plus the page
+// extension of f, so no path separators, dot files or '..'
+bool isPageName(const string &name, Format f) {
+    string ext = pageExtension(f);
+    if (name.size() <= ext.size() || name.compare(name.size() - ext.size(), ext.size(), ext) != 0) return false;
+    return all_of(name.begin(), name.end() - ext.size(),
+                  [](char c) { return isalnum((unsigned char)c) || c == '-' || c == '_'; });
+}
+
+// File names for the role pages, in the order of keys. Characters outside
+// [A-Za-z0-9_-] become '_', so different keys can end up with the same name;
+// those (and a role that would overwrite the index page) get a suffix
+// derived from the key's hash.
+vector<string> pageNames(const vector<string> &keys, Format f) {
+    string ext = pageExtension(f);
+    vector<string> names;
+    unordered_map<string, int> uses{{indexPageName(f), 1}};
+    for (auto &key : keys) {
+        string name;
+        for (char c : key) name.push_back(isalnum((unsigned char)c) || c == '-' || c == '_' ? c : '_');
+        names.push_back(name + ext);
+        ++uses[names.back()];
+    }
+    for (size_t i = 0; i < keys.size(); ++i) {
+        if (uses[names[i]] < 2) continue;
+        ostringstream suffix;
+        suffix << "-" << hex << setw(8) << setfill('0') << uint32_t(hashBytes(keys[i]));
+        names[i].insert(names[i].size() - ext.size(), suffix.str());
+    }
+    return names;
+}
+
+void renderIndex(ostream &out, const vector<string> &keys, const vector<string> &names, Format f) {
+    if (f == Format::Html) {
+        out << "<!DOCTYPE html>\n<html><head><meta charset=\"utf-8\"><title>Roadmaps</title></head>\n<body>\n"
+            << "<h1>Roadmaps</h1>\n<ul>\n";
+        for (size_t i = 0; i < keys.size(); ++i)
+            out << "<li><a href=\"" << names[i] << "\">" << htmlEscape(roadmaps.at(keys[i]).displayName) << "</a></li>\n";
+        out << "</ul>\n</body></html>\n";
+    } else {
+        out << "# Roadmaps\n\n";
+        for (size_t i = 0; i < keys.size(); ++i) out << "- [" << roadmaps.at(keys[i]).displayName << "](" << names[i] << ")\n";
+    }
+}
+
+// Renders every roadmap plus an index into dir. Pages are rendered in parallel
+// into memory and each one is written with a single write. A manifest of
+// content hashes from the previous export in the same format lets unchanged
+// pages be skipped and pages of roles that no longer exist be deleted; only
+// names that are valid page names of that format are ever deleted.
+bool exportCatalog(const string &dir, Format f) {
+    namespace fs = std::filesystem;
+    error_code ec;
+    fs::create_directories(dir, ec);
+    if (ec) {
+        cout << "Cannot create '" << dir << "': " << ec.message() << endl;
+        return false;
+    }
+
+    vector<string> keys = sortedKeys();
+    size_t n = keys.size();
+    vector<string> names = pageNames(keys, f), pages(n + 1);
+    names.push_back(indexPageName(f));
+    if (unordered_set<string>(names.begin(), names.end()).size() != names.size()) {
+        cout << "Cannot export: two roles map to the same page name." << endl;
+        return false;
+    }
+    parallelFor(n + 1, [&](size_t b, size_t e) {
+        for (size_t i = b; i < e; ++i) {
+            ostringstream out;
+            if (i == n) renderIndex(out, keys, names, f);
+            else renderRoadmap(out, roadmaps.at(keys[i]), f);
+            pages[i] = out.str();
+        }
+    }, 16);
+
+    fs::path manifestPath = fs::path(dir) / (".export-manifest" + pageExtension(f));
+    unordered_map<string, uint64_t> previous;
+    {
+        ifstream in(manifestPath);
+        string name;
+        uint64_t h;
+        while (in >> name >> h)
+            if (isPageName(name, f)) previous[name] = h;
+    }
+
+    vector<uint64_t> hashes(n + 1);
+    vector<char> changed(n + 1, 0), failed(n + 1, 0);
+    parallelFor(n + 1, [&](size_t b, size_t e) {
+        for (size_t i = b; i < e; ++i) {
+            hashes[i] = hashBytes(pages[i]);
+            fs::path target = fs::path(dir) / names[i];
+            auto it = previous.find(names[i]);
+            error_code fec;
+            if (it != previous.end() && it->second == hashes[i] && fs::exists(target, fec)) continue;
+            changed[i] = 1;
+            ofstream out(target, ios::binary | ios::trunc);
+            out.write(pages[i].data(), (streamsize)pages[i].size());
+            if (!out) failed[i] = 1;
+        }
+    }, 16);
+
+    // pages the previous export wrote that are not part of this one
+    unordered_set<string> current(names.begin(), names.end());
+    size_t removed = 0;
+    for (auto &kv : previous) {
+        if (current.count(kv.first)) continue;
+        error_code rec;
+        removed += fs::remove(fs::path(dir) / kv.first, rec);
+    }
+
+    ofstream manifest(manifestPath, ios::trunc);
+    size_t written = 0, errors = 0;
+    for (size_t i = 0; i <= n; ++i) {
+        if (failed[i]) {
+            ++errors;
+            cout << "Failed to write " << names[i] << endl;
+            continue; // left out of the manifest so the next export retries it
+        }
+        manifest << names[i] << " " << hashes[i] << "\n";
+        written += changed[i];
+    }
+    cout << "Exported " << n << " roadmaps to '" << dir << "': " << written << " written, "
+         << (n + 1 - written - errors) << " unchanged, " << removed << " removed" << (errors ? ", " + to_string(errors) + " failed" : "") << "." << endl;
+    return errors == 0;
+}
+
+// ---------------- related roles (TF-IDF) ----------------
+
+// position of key in roleKeys, or -1
+int roleIdOf(const string &key) {
+    auto it = lower_bound(roleKeys.begin(), roleKeys.end(), key);
+    return it != roleKeys.end() && *it == key ? int(it - roleKeys.begin()) : -1;
+}
+
+bool isStopword(const string &w) {
+    static const unordered_set<string> stop = {
+        "a", "an", "and", "are", "as", "at", "be", "by", "e", "g", "for", "from", "how", "in", "into",
+        "is", "it", "of", "on", "or", "s", "the", "their", "to", "use", "using", "vs", "when", "where",
+        "which", "with", "your"};
+    return w.size() < 2 || stop.count(w) > 0;
+}
+
+// Per-role term counts are kept, keyed by role key so they survive role IDs
+// shifting when roles are added, and a change to a few roadmaps only
+// re-tokenizes those; the weighted vectors and the inverted index are then
+// rebuilt from counts, which touches no text.
+struct RelatedIndex {
+    unordered_map<string, uint32_t> termIds;
+    vector<uint32_t> df; // roles containing each term
+    unordered_map<string, vector<pair<uint32_t, uint32_t>>> counts; // role key -> (term, count), sorted by term
+
+    // L2-normalized TF-IDF vectors, CSR by role
+    vector<uint32_t> vecStart, vecTerm;
+    vector<float> vecWeight;
+    // the same weights transposed, CSR by term
+    vector<uint32_t> postStart, postRole;
+    vector<float> postWeight;
+
+    // word -> count over a roadmap's titles and steps; reads nothing shared
+    // that changes, so roles are counted in parallel
+    static unordered_map<string, uint32_t> wordCounts(const Roadmap &r) {
+        unordered_map<string, uint32_t> c;
+        auto addText = [&](const string &text) {
+            for (auto &w : tokenize(text))
+                if (!isStopword(w)) ++c[w];
+        };
+        for (auto &p : r.phases) {
+            addText(p.title);
+            for (uint32_t id : p.steps) addText(stepTexts[id]);
+        }
+        return c;
+    }
+
+    // Re-counts the given roles (all of them on the first build), drops
+    // roles that no longer exist, then reweights in roleKeys order. Words
+    // are counted in parallel; term IDs are then assigned serially in
+    // changedKeys order, so they do not depend on the thread count.
+    void update(const vector<string> &changedKeys) {
+        size_t n = changedKeys.size();
+        vector<unordered_map<string, uint32_t>> words(n);
+        parallelFor(n, [&](size_t b, size_t e) {
+            for (size_t i = b; i < e; ++i) {
+                auto r = roadmaps.find(changedKeys[i]);
+                if (r != roadmaps.end()) words[i] = wordCounts(r->second);
+            }
+        });
+        for (size_t i = 0; i < n; ++i) {
+            const string &key = changedKeys[i];
+            auto old = counts.find(key);
+            if (old != counts.end()) {
+                for (auto &tc : old->second) --df[tc.first];
+                counts.erase(old);
+            }
+            if (!roadmaps.count(key)) continue;
+            vector<pair<uint32_t, uint32_t>> c;
+            c.reserve(words[i].size());
+            for (auto &wc : words[i]) {
+                auto it = termIds.find(wc.first);
+                if (it == termIds.end()) {
+                    it = termIds.emplace(wc.first, (uint32_t)df.size()).first;
+                    df.push_back(0);
+                }
+                c.push_back({it->second, wc.second});
+            }
+            sort(c.begin(), c.end());
+            for (auto &tc : c) ++df[tc.first];
+            counts[key] = move(c);
+            unordered_map<string, uint32_t>().swap(words[i]);
+        }
+        reweight();
+    }
+
+    void reweight() {
+        size_t n = roleKeys.size(), terms = df.size();
+        vector<float> idf(terms);
+        for (size_t t = 0; t < terms; ++t) idf[t] = df[t] ? log(float(n) / df[t]) : 0.f;
+
+        vecStart.assign(1, 0);
+        vecTerm.clear();
+        vecWeight.clear();
+        vector<uint32_t> perTerm(terms, 0);
+        for (size_t id = 0; id < n; ++id) {
+            size_t from = vecTerm.size();
+            float norm = 0;
+            for (auto &tc : counts.at(roleKeys[id])) {
+                float w = (1 + log(float(tc.second))) * idf[tc.first];
+                if (w <= 0) continue; // term used by every role carries no signal
+                vecTerm.push_back(tc.first);
+                vecWeight.push_back(w);
+                norm += w * w;
+                ++perTerm[tc.first];
+            }
+            norm = sqrt(norm);
+            for (size_t i = from; i < vecWeight.size(); ++i) vecWeight[i] /= norm;
+            vecStart.push_back((uint32_t)vecTerm.size());
+        }
+
+        postStart.assign(terms + 1, 0);
+        for (size_t t = 0; t < terms; ++t) postStart[t + 1] = postStart[t] + perTerm[t];
+        postRole.resize(vecTerm.size());
+        postWeight.resize(vecTerm.size());
+        vector<uint32_t> fill(postStart.begin(), postStart.end() - 1);
+        for (uint32_t id = 0; id < n; ++id) {
+            for (uint32_t i = vecStart[id]; i < vecStart[id + 1]; ++i) {
+                uint32_t slot = fill[vecTerm[i]]++;
+                postRole[slot] = id;
+                postWeight[slot] = vecWeight[i];
+            }
+        }
+    }
+
+    // Top-k roles by cosine similarity to role id. Scores are accumulated
+    // sparsely over the postings of the role's own terms only, so the cost
+    // depends on how many roles share its vocabulary rather than on catalog size.
+    vector<pair<uint32_t, float>> topK(uint32_t id, size_t k) const {
+        unordered_map<uint32_t, float> score;
+        for (uint32_t i = vecStart[id]; i < vecStart[id + 1]; ++i) {
+            float w = vecWeight[i];
+            uint32_t t = vecTerm[i];
+            for (uint32_t j = postStart[t]; j < postStart[t + 1]; ++j) score[postRole[j]] += w * postWeight[j];
+        }
+        vector<pair<uint32_t, float>> out;
+        for (auto &rs : score)
+            if (rs.first != id && rs.second > 0) out.push_back(rs);
+        auto better = [](const pair<uint32_t, float> &a, const pair<uint32_t, float> &b) {
+            return a.second != b.second ? a.second > b.second : a.first < b.first;
+        };
+        k = min(k, out.size());
+        partial_sort(out.begin(), out.begin() + k, out.end(), better);
+        out.resize(k);
+        return out;
+    }
+};
+
+RelatedIndex relatedIndex;
+
+void buildRelatedIndex(const vector<string> &changedKeys) {
+    MemScope scope(MemRelated);
+    relatedIndex.update(changedKeys);
+}
+
+// "Related roles: A, B, C" line shown under a roadmap
+string relatedLine(const string &key, size_t k = 3) {
+    int id = roleIdOf(key);
+    if (id < 0) return "";
+    string out;
+    for (auto &rs : relatedIndex.topK((uint32_t)id, k))
+        out += (out.empty() ? "" : ", ") + roadmaps[roleKeys[rs.first]].displayName;
+    return out.empty() ? "" : "Related roles: " + out;
+}
+
+// ---------------- prerequisite graph ----------------
+
+// Nodes are the shared steps (IDs 0..stepTexts.size()-1) followed by one node
+// per phase of every role. An edge u -> v means u is a prerequisite of v:
+// every step of a phase leads to that phase's node, a phase's node leads to
+// every step of the next phase, and the last phase of a prerequisite role
+// leads to every step of the dependent role's first phase. Steps shared
+// between roles join the roadmaps further. Adjacency is stored in CSR form in
+// both directions.
+struct SkillGraph {
+    uint32_t stepNodes = 0;
+    vector<uint32_t> phaseBase;      // per role ID: node of its first phase
+    vector<uint32_t> outStart, outAdj;
+    vector<uint32_t> inStart, inAdj;
+    vector<uint32_t> topoRank;       // position in a topological order
+
+    uint32_t nodeCount() const { return (uint32_t)outStart.size() - 1; }
+
+    static void toCsr(uint32_t nodes, const vector<pair<uint32_t, uint32_t>> &edges, bool reverse,
+                      vector<uint32_t> &start, vector<uint32_t> &adj) {
+        start.assign(nodes + 1, 0);
+        for (auto &e : edges) ++start[(reverse ? e.second : e.first) + 1];
+        for (uint32_t i = 0; i < nodes; ++i) start[i + 1] += start[i];
+        adj.resize(edges.size());
+        vector<uint32_t> fill(start.begin(), start.end() - 1);
+        for (auto &e : edges) {
+            uint32_t from = reverse ? e.second : e.first, to = reverse ? e.first : e.second;
+            adj[fill[from]++] = to;
+        }
+    }
+
+    void build() {
+        MemScope scope(MemGraph);
+        stepNodes = (uint32_t)stepTexts.size();
+        phaseBase.clear();
+        vector<pair<uint32_t, uint32_t>> edges;
+        uint32_t next = stepNodes;
+        for (uint32_t id = 0; id < roleKeys.size(); ++id) {
+            phaseBase.push_back(next);
+            next += (uint32_t)roadmaps.at(roleKeys[id]).phases.size();
+        }
+        phaseBase.push_back(next);
+        // edges of each role in parallel, then concatenated in role order
+        vector<vector<pair<uint32_t, uint32_t>>> roleEdges(roleKeys.size());
+        parallelFor(roleKeys.size(), [&](size_t b, size_t e) {
+            for (size_t id = b; id < e; ++id) {
+                const Roadmap &r = roadmaps.at(roleKeys[id]);
+                auto &out = roleEdges[id];
+                for (uint32_t pi = 0; pi < r.phases.size(); ++pi) {
+                    uint32_t node = phaseBase[id] + pi;
+                    for (uint32_t st : r.phases[pi].steps) {
+                        out.push_back({st, node});
+                        if (pi > 0) out.push_back({node - 1, st});
+                    }
+                }
+                if (r.phases.empty()) continue;
+                for (auto &pre : r.prerequisites) {
+                    int pid = roleIdOf(pre);
+                    if (pid < 0 || phaseBase[pid] == phaseBase[pid + 1]) continue;
+                    for (uint32_t st : r.phases[0].steps) out.push_back({goalOf((uint32_t)pid), st});
+                }
+            }
+        });
+        size_t total = 0;
+        for (auto &re : roleEdges) total += re.size();
+        edges.reserve(total);
+        for (auto &re : roleEdges) {
+            edges.insert(edges.end(), re.begin(), re.end());
+            vector<pair<uint32_t, uint32_t>>().swap(re);
+        }
+        sort(edges.begin(), edges.end());
+        edges.erase(unique(edges.begin(), edges.end()), edges.end());
+        toCsr(next, edges, false, outStart, outAdj);
+        toCsr(next, edges, true, inStart, inAdj);
+
+        // Kahn's algorithm; nodes left on a cycle (possible when two roles
+        // order a shared step differently) are ranked last, in ID order
+        vector<uint32_t> indeg(next), order;
+        for (uint32_t v = 0; v < next; ++v) indeg[v] = inStart[v + 1] - inStart[v];
+        for (uint32_t v = 0; v < next; ++v)
+            if (!indeg[v]) order.push_back(v);
+        for (size_t i = 0; i < order.size(); ++i)
+            for (uint32_t j = outStart[order[i]]; j < outStart[order[i] + 1]; ++j)
+                if (--indeg[outAdj[j]] == 0) order.push_back(outAdj[j]);
+        topoRank.assign(next, UINT32_MAX);
+        for (uint32_t i = 0; i < order.size(); ++i) topoRank[order[i]] = i;
+        uint32_t rank = (uint32_t)order.size();
+        for (uint32_t v = 0; v < next; ++v)
+            if (topoRank[v] == UINT32_MAX) topoRank[v] = rank++;
+    }
+
+    // final phase node of a role: it depends on everything in the roadmap
+    uint32_t goalOf(uint32_t role) const { return phaseBase[role + 1] - 1; }
+
+    // Marks every node that `from` depends on (and `from` itself) in seen,
+    // without walking through nodes already set in stop. Level-synchronous
+    // BFS over the reverse edges with the frontier kept as a bitset.
+    void ancestors(uint32_t from, vector<uint64_t> &seen, const vector<uint64_t> *stop) const {
+        size_t words = (nodeCount() + 63) / 64;
+        seen.resize(words, 0);
+        vector<uint64_t> frontier(words, 0), nextFrontier(words, 0);
+        frontier[from / 64] |= 1ULL << (from % 64);
+        seen[from / 64] |= 1ULL << (from % 64);
+        for (bool any = true; any;) {
+            any = false;
+            fill(nextFrontier.begin(), nextFrontier.end(), 0);
+            for (size_t w = 0; w < words; ++w) {
+                for (uint64_t b = frontier[w]; b; b &= b - 1) {
+                    uint32_t v = uint32_t(w * 64 + __builtin_ctzll(b));
+                    for (uint32_t j = inStart[v]; j < inStart[v + 1]; ++j) {
+                        uint32_t u = inAdj[j];
+                        uint64_t bit = 1ULL << (u % 64);
+                        if ((seen[u / 64] & bit) || (stop && ((*stop)[u / 64] & bit))) continue;
+                        seen[u / 64] |= bit;
+                        nextFrontier[u / 64] |= bit;
+                        any = true;
+                    }
+                }
+            }
+            swap(frontier, nextFrontier);
+        }
+    }
+
+    // a role and, transitively, every role it lists as a prerequisite
+    static vector<uint32_t> withPrerequisites(uint32_t role) {
+        vector<uint32_t> out{role};
+        set<uint32_t> seen{role};
+        for (size_t i = 0; i < out.size(); ++i) {
+            for (auto &pre : roadmaps.at(roleKeys[out[i]]).prerequisites) {
+                int pid = roleIdOf(pre);
+                if (pid >= 0 && seen.insert((uint32_t)pid).second) out.push_back((uint32_t)pid);
+            }
+        }
+        return out;
+    }
+
+    // Steps still to learn to complete role `to` for someone who has
+    // completed role `from` (and so its prerequisite roles), in topological
+    // order. The walk may enter `to` and its prerequisite roles; it stops at
+    // everything `from` covers and at phases of any other role, so a step
+    // shared with an unrelated role does not pull in that role's earlier
+    // phases.
+    vector<uint32_t> delta(uint32_t from, uint32_t to) const {
+        uint32_t nodes = nodeCount();
+        vector<uint64_t> stop((nodes + 63) / 64, 0), needed;
+        auto mark = [&](uint32_t v, bool on) {
+            if (on) stop[v / 64] |= 1ULL << (v % 64);
+            else stop[v / 64] &= ~(1ULL << (v % 64));
+        };
+        for (uint32_t v = stepNodes; v < nodes; ++v) mark(v, true);
+        for (uint32_t role : withPrerequisites(to))
+            for (uint32_t v = phaseBase[role]; v < phaseBase[role + 1]; ++v) mark(v, false);
+        for (uint32_t role : withPrerequisites(from)) {
+            for (uint32_t v = phaseBase[role]; v < phaseBase[role + 1]; ++v) mark(v, true);
+            for (auto &p : roadmaps.at(roleKeys[role]).phases)
+                for (uint32_t st : p.steps) mark(st, true);
+        }
+        if ((stop[goalOf(to) / 64] >> (goalOf(to) % 64)) & 1) return {}; // `from` already covers `to`
+        ancestors(goalOf(to), needed, &stop);
+
+        vector<uint32_t> steps;
+        for (uint32_t v = 0; v < stepNodes; ++v)
+            if ((needed[v / 64] >> (v % 64)) & 1) steps.push_back(v);
+        sort(steps.begin(), steps.end(), [&](uint32_t a, uint32_t b) { return topoRank[a] < topoRank[b]; });
+        return steps;
+    }
+};
+
+SkillGraph skillGraph;
+
+// ---------------- learner progress ----------------
+
+// Steps are addressed by their position in the roadmap: phase by phase, step
+// by step, starting at 0. The index is stable as long as the role's layout
+// (number of steps per phase) is unchanged; layoutHash() detects when it is not.
+size_t stepCount(const Roadmap &r) {
+    size_t n = 0;
+    for (auto &p : r.phases) n += p.steps.size();
+    return n;
+}
+
+uint32_t layoutHash(const Roadmap &r) {
+    string shape;
+    for (auto &p : r.phases) shape += to_string(p.steps.size()) + ",";
+    uint32_t h = uint32_t(hashBytes(shape));
+    return h ? h : 1; // 0 marks a slot being reset
+}
+
+// "2.3" -> flat step index, or -1 if it does not name a step of r
+long stepIndex(const Roadmap &r, const string &ref) {
+    size_t dot = ref.find('.');
+    if (dot == string::npos) return -1;
+    long phase = 0, step = 0;
+    try {
+        phase = stol(ref.substr(0, dot));
+        step = stol(ref.substr(dot + 1));
+    } catch (...) {
+        return -1;
+    }
+    if (phase < 1 || phase > (long)r.phases.size()) return -1;
+    if (step < 1 || step > (long)r.phases[phase - 1].steps.size()) return -1;
+    long idx = 0;
+    for (long i = 0; i < phase - 1; ++i) idx += (long)r.phases[i].steps.size();
+    return idx + step - 1;
+}
+
+// Memory-mapped file of fixed-size slots, one per (user, role), holding one
+// bit per step. The slots double as an open-addressing hash directory keyed
+// by a hash of user and role, so every lookup is O(1) expected. Writes go to
+// the mapping and are flushed with msync: a step update is a single aligned
+// 8-byte store, and a new slot is filled before its key is stored, so a
+// crash leaves either the old or the new state. A layout change (the role's
+// steps changed) first zeroes `layout`, which makes the slot read as empty,
+// then resets the bits and stores the new layout last. Growing rewrites the
+// table into a temporary file and renames it over the old one.
+//
+// Several processes may share the file (one-shot 'done' commands): updates
+// hold an exclusive flock and reads a shared one. A process that grew the
+// table renamed a new file over the path, so after taking the lock the
+// others check the inode and remap if it changed.
+struct ProgressStore {
+    static constexpr uint64_t kMagic = 0x31474f52504d52ULL; // "RMPROG1"
+    static constexpr size_t kMaxSteps = 320;
+
+    struct Header {
+        uint64_t magic;
+        uint64_t capacity; // number of slots, a power of two
+        uint64_t used;
+        uint64_t reserved[5];
+    };
+    struct Slot {
+        uint64_t key;   // 0 = empty
+        uint64_t check; // second hash of (user, role) to rule out key collisions
+        uint32_t steps;
+        uint32_t layout;
+        uint64_t bits[kMaxSteps / 64];
+    };
+    static_assert(sizeof(Header) == 64 && sizeof(Slot) == 64, "slots must stay 64 bytes");
+
+    string path;
+    int fd = -1;
+    char *base = nullptr;
+    size_t size = 0;
+
+    ~ProgressStore() { close(); }
+
+    Header *header() { return (Header *)base; }
+    Slot *slots() { return (Slot *)(base + sizeof(Header)); }
+
+    void close() {
+        if (base) munmap(base, size);
+        if (fd >= 0) ::close(fd);
+        base = nullptr;
+        fd = -1;
+    }
+
+    static bool createFile(const string &file, uint64_t capacity) {
+        int f = ::open(file.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (f < 0) return false;
+        Header h{kMagic, capacity, 0, {}};
+        bool ok = ftruncate(f, off_t(sizeof(Header) + capacity * sizeof(Slot))) == 0 &&
+                  pwrite(f, &h, sizeof h, 0) == (ssize_t)sizeof h && fsync(f) == 0;
+        ::close(f);
+        return ok;
+    }
+
+    bool open(const string &file) {
+        close();
+        path = file;
+        struct stat st;
+        if (stat(file.c_str(), &st) != 0 && !createFile(file, 1024)) return false;
+        fd = ::open(file.c_str(), O_RDWR);
+        if (fd < 0 || fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(Header)) {
+            close();
+            return false;
+        }
+        size = (size_t)st.st_size;
+        void *m = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (m == MAP_FAILED) {
+            close();
+            return false;
+        }
+        base = (char *)m;
+        if (header()->magic != kMagic || sizeof(Header) + header()->capacity * sizeof(Slot) != size) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    // locks the file for one operation (LOCK_EX or LOCK_SH), first
+    // remapping it if another process replaced it by growing
+    bool lock(int op) {
+        for (;;) {
+            if (!base || flock(fd, op) != 0) return false;
+            struct stat mine, current;
+            if (fstat(fd, &mine) == 0 && stat(path.c_str(), &current) == 0 && mine.st_ino == current.st_ino &&
+                mine.st_dev == current.st_dev)
+                return true;
+            flock(fd, LOCK_UN);
+            if (!open(path)) return false;
+        }
+    }
+
+    struct LockGuard {
+        ProgressStore &store;
+        bool ok;
+        LockGuard(ProgressStore &s, int op) : store(s), ok(s.lock(op)) {}
+        ~LockGuard() {
+            if (ok) flock(store.fd, LOCK_UN);
+        }
+    };
+
+    void flush(const void *p, size_t len) {
+        uintptr_t page = (uintptr_t)sysconf(_SC_PAGESIZE);
+        uintptr_t b = (uintptr_t)p & ~(page - 1), e = (uintptr_t)p + len;
+        msync((void *)b, e - b, MS_SYNC);
+    }
+
+    static uint64_t keyOf(const string &user, const string &role) {
+        uint64_t k = hashBytes(user + '\0' + role);
+        return k ? k : 1;
+    }
+    static uint64_t checkOf(const string &user, const string &role) {
+        return hashBytes(role + '\0' + user, 0x84222325cbf29ce4ULL);
+    }
+
+    // slot of (user, role), or nullptr if it has none and create is false
+    Slot *find(const string &user, const string &role, bool create) {
+        if (!base) return nullptr;
+        uint64_t key = keyOf(user, role), check = checkOf(user, role);
+        for (;;) {
+            uint64_t mask = header()->capacity - 1;
+            for (uint64_t i = key & mask;; i = (i + 1) & mask) {
+                Slot &s = slots()[i];
+                if (s.key == key && s.check == check) return &s;
+                if (s.key != 0) continue;
+                if (!create) return nullptr;
+                if ((header()->used + 1) * 10 > header()->capacity * 7) break; // grow first
+                s.check = check;
+                s.steps = 0;
+                s.layout = 0;
+                memset(s.bits, 0, sizeof s.bits);
+                flush(&s, sizeof s);
+                s.key = key; // publish
+                flush(&s, sizeof s);
+                header()->used++;
+                flush(header(), sizeof(Header));
+                return &s;
+            }
+            if (!grow()) return nullptr;
+        }
+    }
+
+    bool grow() {
+        string tmp = path + ".tmp";
+        uint64_t cap = header()->capacity * 2;
+        if (!createFile(tmp, cap)) return false;
+        ProgressStore next;
+        if (!next.open(tmp)) return false;
+        for (uint64_t i = 0; i < header()->capacity; ++i) {
+            const Slot &s = slots()[i];
+            if (!s.key) continue;
+            for (uint64_t j = s.key & (cap - 1);; j = (j + 1) & (cap - 1)) {
+                if (next.slots()[j].key) continue;
+                next.slots()[j] = s;
+                break;
+            }
+        }
+        next.header()->used = header()->used;
+        if (msync(next.base, next.size, MS_SYNC) != 0) return false;
+        // lock the new file before it becomes visible and keep its mapping,
+        // so no other process can write to it before this update finishes
+        if (flock(next.fd, LOCK_EX) != 0 || rename(tmp.c_str(), path.c_str()) != 0) return false;
+        close();
+        swap(fd, next.fd);
+        swap(base, next.base);
+        swap(size, next.size);
+        return true;
+    }
+
+    // sets or clears one step bit; resets the slot if the role's layout changed
+    bool mark(const string &user, const string &roleKey, const Roadmap &r, size_t step, bool done) {
+        LockGuard guard(*this, LOCK_EX);
+        if (!guard.ok) return false;
+        Slot *s = find(user, roleKey, true);
+        if (!s) return false;
+        uint32_t layout = layoutHash(r);
+        if (s->layout != layout || s->steps != stepCount(r)) {
+            s->layout = 0; // invalid until the reset is complete
+            flush(s, sizeof *s);
+            memset(s->bits, 0, sizeof s->bits);
+            s->steps = (uint32_t)stepCount(r);
+            flush(s, sizeof *s);
+            s->layout = layout;
+        }
+        uint64_t bit = 1ULL << (step & 63);
+        s->bits[step >> 6] = done ? (s->bits[step >> 6] | bit) : (s->bits[step >> 6] & ~bit);
+        flush(s, sizeof *s);
+        return true;
+    }
+
+    // bits of (user, role), or nullptr if none are recorded for the current layout
+    const Slot *get(const string &user, const string &roleKey, const Roadmap &r) {
+        LockGuard guard(*this, LOCK_SH);
+        if (!guard.ok) return nullptr;
+        Slot *s = find(user, roleKey, false);
+        if (!s || s->layout != layoutHash(r) || s->steps != stepCount(r)) return nullptr;
+        return s;
+    }
+};
+
+const char *kProgressFile = "roadmap-progress.db";
+ProgressStore progressStore;
+
+bool openProgress() {
+    if (progressStore.base) return true;
+    if (progressStore.open(kProgressFile)) return true;
+    cout << "Cannot open progress file '" << kProgressFile << "'." << endl;
+    return false;
+}
+
+// done steps in [begin, end) of a slot's bit array
+size_t countDone(const ProgressStore::Slot &s, size_t begin, size_t end) {
+    size_t n = 0;
+    for (size_t w = begin / 64; w * 64 < end; ++w) {
+        uint64_t bits = s.bits[w];
+        if (w * 64 < begin) bits &= ~0ULL << (begin - w * 64);
+        if (end - w * 64 < 64) bits &= (1ULL << (end - w * 64)) - 1;
+        n += __builtin_popcountll(bits);
+    }
+    return n;
+}
+
+string percent(size_t done, size_t total, int decimals = 0) {
+    ostringstream out;
+    out << fixed << setprecision(decimals) << (total ? 100.0 * done / total : 0.0) << "%";
+    return out.str();
+}
+
+// ---------------- tenant overlays ----------------
+
+// A tenant sees the base catalog through a sparse delta: roles it added,
+// removed or edited phase by phase. Nothing of the base is copied; a
+// tenant's roadmap is assembled from base phases plus its own edits when it
+// is looked up. Steps reuse the base step when the text is identical; new
+// texts go to tenantStepTexts, shared by all tenants.
+struct RoleDelta {
+    bool removed = false;
+    bool added = false;     // not in the base catalog
+    string displayName;     // for added roles
+    map<uint32_t, Phase> replacedPhases; // base phase index -> replacement
+    set<uint32_t> removedPhases;
+    vector<Phase> appendedPhases;
+};
+
+struct TenantOverlay {
+    string name;
+    map<string, RoleDelta> roles; // by role key
+    vector<string> addedKeys;     // role IDs roleKeys.size() + i
+
+    // Filter index derived from the base: `changed` holds base roles whose
+    // content the tenant altered or removed, `terms` the postings of the
+    // tenant's altered and added roles. A term's roles for this tenant are
+    // (base AND NOT changed) OR terms.
+    RoleBitmap changed, visible;
+    unordered_map<string, RoleBitmap> terms;
+    unordered_map<string, RoleBitmap> merged; // cache of combined postings
+
+    bool hides(const string &key) const {
+        auto it = roles.find(key);
+        return it != roles.end() && it->second.removed;
+    }
+
+    // the tenant's version of a role; false if the tenant does not have it
+    bool resolve(const string &key, Roadmap &out) const {
+        auto it = roles.find(key);
+        auto base = roadmaps.find(key);
+        if (it == roles.end()) {
+            if (base == roadmaps.end()) return false;
+            out = base->second;
+            return true;
+        }
+        const RoleDelta &d = it->second;
+        if (d.removed || (!d.added && base == roadmaps.end())) return false;
+        out = Roadmap{};
+        if (d.added) {
+            out.displayName = d.displayName;
+            out.searchName = normalize(d.displayName);
+        } else {
+            out.displayName = base->second.displayName;
+            out.searchName = base->second.searchName;
+            const vector<Phase> &phases = base->second.phases;
+            for (uint32_t i = 0; i < phases.size(); ++i) {
+                if (d.removedPhases.count(i)) continue;
+                auto rp = d.replacedPhases.find(i);
+                out.phases.push_back(rp != d.replacedPhases.end() ? rp->second : phases[i]);
+            }
+        }
+        out.phases.insert(out.phases.end(), d.appendedPhases.begin(), d.appendedPhases.end());
+        return true;
+    }
+
+    template <class F>
+    void forEachRole(F fn) const {
+        Roadmap r;
+        for (auto &kv : roadmaps) {
+            if (!roles.count(kv.first)) fn(kv.first, kv.second); // untouched: no copy
+            else if (resolve(kv.first, r)) fn(kv.first, r);
+        }
+        for (auto &k : addedKeys)
+            if (resolve(k, r)) fn(k, r);
+    }
+
+    string keyOfId(uint32_t id) const { return id < roleKeys.size() ? roleKeys[id] : addedKeys[id - roleKeys.size()]; }
+
+    // Touches only the roles in the delta; the base postings are shared.
+    void buildIndex() {
+        changed = RoleBitmap{};
+        terms.clear();
+        merged.clear();
+        RoleBitmap added;
+        for (auto &kv : roles) {
+            int id = roleIdOf(kv.first);
+            if (id < 0) {
+                auto pos = find(addedKeys.begin(), addedKeys.end(), kv.first);
+                if (pos == addedKeys.end()) continue;
+                id = int(roleKeys.size() + (pos - addedKeys.begin()));
+            } else {
+                changed.add((uint32_t)id);
+            }
+            Roadmap r;
+            if (!resolve(kv.first, r)) continue;
+            if (id >= (int)roleKeys.size()) added.add((uint32_t)id);
+            for (auto &t : roleTerms(r)) terms[t].add((uint32_t)id);
+        }
+        RoleBitmap removed;
+        for (auto &kv : roles)
+            if (kv.second.removed && roleIdOf(kv.first) >= 0) removed.add((uint32_t)roleIdOf(kv.first));
+        visible = RoleBitmap::combine(RoleBitmap::combine(allRoles, removed, RoleBitmap::Op::AndNot), added,
+                                      RoleBitmap::Op::Or);
+    }
+
+    const RoleBitmap *posting(const string &term) {
+        auto cached = merged.find(term);
+        if (cached != merged.end()) return &cached->second;
+        auto base = termIndex.find(term);
+        auto own = terms.find(term);
+        if (own == terms.end() && (base == termIndex.end() || changed.chunks.empty()))
+            return base == termIndex.end() ? nullptr : &base->second; // untouched: share the base posting
+        RoleBitmap r = base == termIndex.end() ? RoleBitmap{}
+                                               : RoleBitmap::combine(base->second, changed, RoleBitmap::Op::AndNot);
+        if (own != terms.end()) r = RoleBitmap::combine(r, own->second, RoleBitmap::Op::Or);
+        return &(merged[term] = move(r));
+    }
+};
+
+map<string, TenantOverlay> tenants;
+TenantOverlay *currentTenant = nullptr;
+
+unordered_multimap<uint64_t, uint32_t> tenantStepIds; // hashBytes(text) -> ID in tenantStepTexts
+
+// ID of a step text: a base step found through the dedup band index, else
+// a tenant step, added if new. Nothing catalog-sized is built for this.
+uint32_t internStep(const string &text) {
+    uint32_t base = stepDedup.findExact(text);
+    if (base != UINT32_MAX) return base;
+    MemScope scope(MemTenants);
+    uint64_t h = hashBytes(text);
+    for (auto range = tenantStepIds.equal_range(h); range.first != range.second; ++range.first)
+        if (stepText(range.first->second) == text) return range.first->second;
+    uint32_t id = (uint32_t)tenantStepTexts.size() | kTenantStep;
+    tenantStepTexts.push_back(text);
+    tenantStepIds.emplace(h, id);
+    return id;
+}
+
+// Reads a tenant delta. One directive per line, '#' starts a comment:
+//   role <name>            select a role to edit (creates it if the base has none)
+//   remove role <name>
+//   phase <n> <TITLE>      replace phase n of the selected role; 'step' lines follow
+//   remove phase <n>
+//   add phase <TITLE>      append a phase; 'step' lines follow
+//   step <text>
+bool loadTenant(const string &name, const string &file) {
+    MemScope scope(MemTenants);
+    ifstream in(file);
+    if (!in) {
+        cout << "Cannot read '" << file << "'." << endl;
+        return false;
+    }
+    TenantOverlay t;
+    t.name = name;
+    RoleDelta *role = nullptr;
+    string roleKey;
+    Phase *phase = nullptr;
+    string line;
+    int lineNo = 0;
+    auto fail = [&](const string &why) {
+        cout << file << ":" << lineNo << ": " << why << endl;
+        return false;
+    };
+    // index of phase number `word` of the selected base role; -1 if it is
+    // not a number in 1..phase count
+    auto basePhase = [&](const string &word) {
+        size_t count = roadmaps.at(roleKey).phases.size();
+        if (word.empty() || word.size() > 9 || !all_of(word.begin(), word.end(), [](char c) { return isdigit((unsigned char)c); }))
+            return -1L;
+        long n = stol(word);
+        return n >= 1 && (size_t)n <= count ? n - 1 : -1L;
+    };
+    auto badPhase = [&](const string &word) {
+        return fail("no phase '" + word + "' in " + roadmaps.at(roleKey).displayName + " (it has " +
+                    to_string(roadmaps.at(roleKey).phases.size()) + ")");
+    };
+    while (getline(in, line)) {
+        ++lineNo;
+        vector<string> words = splitWords(line);
+        if (words.empty() || words[0][0] == '#') continue;
+        string op = normalize(words[0]);
+        string arg = restOf(line, 1);
+        if (op == "role") {
+            string key = keyify(arg);
+            if (key.empty()) return fail("role needs a name");
+            role = &t.roles[key];
+            roleKey = key;
+            phase = nullptr;
+            if (!roadmaps.count(key) && !role->added) {
+                role->added = true;
+                role->displayName = arg;
+                t.addedKeys.push_back(key);
+            }
+            role->removed = false;
+        } else if (op == "remove" && words.size() > 2 && normalize(words[1]) == "role") {
+            string key = keyify(restOf(line, 2));
+            t.roles[key] = RoleDelta{};
+            t.roles[key].removed = true;
+            role = nullptr;
+            phase = nullptr;
+        } else if (op == "remove" && words.size() == 3 && normalize(words[1]) == "phase") {
+            if (!role || role->added) return fail("remove phase needs a base role selected with 'role'");
+            long index = basePhase(words[2]);
+            if (index < 0) return badPhase(words[2]);
+            role->removedPhases.insert((uint32_t)index);
+            phase = nullptr;
+        } else if (op == "phase" && words.size() > 2) {
+            if (!role || role->added) return fail("phase <n> needs a base role selected with 'role'");
+            long index = basePhase(words[1]);
+            if (index < 0) return badPhase(words[1]);
+            phase = &role->replacedPhases[(uint32_t)index];
+            *phase = Phase{restOf(line, 2), {}};
+        } else if (op == "add" && words.size() > 2 && normalize(words[1]) == "phase") {
+            if (!role) return fail("add phase needs a role selected with 'role'");
+            role->appendedPhases.push_back(Phase{restOf(line, 2), {}});
+            phase = &role->appendedPhases.back();
+        } else if (op == "step") {
+            if (!phase) return fail("step outside a phase");
+            phase->steps.push_back(internStep(arg));
+        } else {
+            return fail("unknown directive '" + words[0] + "'");
+        }
+    }
+    t.buildIndex();
+    bool wasCurrent = currentTenant && currentTenant->name == name;
+    tenants[name] = move(t);
+    if (wasCurrent) currentTenant = &tenants[name];
+    return true;
+}
+
+// role lookups as the current tenant (or the base catalog) sees them
+vector<string> lookupRoles(const string &input) {
+    if (!currentTenant) return findMatches(input);
+    return matchRoles(input, [](auto fn) { currentTenant->forEachRole(fn); });
+}
+
+Roadmap resolveRole(const string &key) {
+    Roadmap r;
+    if (!currentTenant) r = roadmaps.at(key);
+    else currentTenant->resolve(key, r);
+    return r;
+}
+
+// the current view's version of a role: the base roadmap itself when the
+// tenant did not touch it, otherwise resolved into scratch
+const Roadmap &viewRole(const string &key, Roadmap &scratch) {
+    if (!currentTenant || !currentTenant->roles.count(key)) return roadmaps.at(key);
+    currentTenant->resolve(key, scratch);
+    return scratch;
+}
+
+// progress slot name of a role; a tenant's view of a role is tracked apart
+// from the base one, as its phases and numbering may differ
+string progressKey(const string &key) {
+    return currentTenant ? currentTenant->name + "/" + key : key;
+}
+
+// relatedLine() for the current view; empty for roles the tenant added or
+// edited, as the related index only has vectors for the base content
+string viewRelatedLine(const string &key) {
+    if (currentTenant && currentTenant->roles.count(key)) return "";
+    return relatedLine(key);
+}
+
+// ---------------- memory report ----------------
+
+// heap bytes behind a string; 0 when the text fits in the string itself (SSO)
+size_t heapBytes(const string &s) {
+    const char *self = (const char *)&s;
+    bool inline_ = s.data() >= self && s.data() < self + sizeof(string);
+    return inline_ ? 0 : s.capacity() + 1;
+}
+
+template <class T>
+size_t heapBytes(const vector<T> &v) {
+    return v.capacity() * sizeof(T);
+}
+
+template <class T>
+size_t slackBytes(const vector<T> &v) {
+    return (v.capacity() - v.size()) * sizeof(T);
+}
+
+size_t slackBytes(const string &s) {
+    return heapBytes(s) ? s.capacity() - s.size() : 0;
+}
+
+// bucket array plus nodes (next pointer, value, cached hash) of a hash map
+template <class M>
+size_t hashMapBytes(const M &m) {
+    return m.bucket_count() * sizeof(void *) + m.size() * (sizeof(void *) + sizeof(typename M::value_type) + sizeof(size_t));
+}
+
+// nodes (three links and a colour, plus the value) of a std::map or std::set
+template <class M>
+size_t treeBytes(const M &m) {
+    return m.size() * (4 * sizeof(void *) + sizeof(typename M::value_type));
+}
+
+size_t heapBytes(const RoleBitmap &b) {
+    size_t n = heapBytes(b.chunks);
+    for (auto &c : b.chunks) n += heapBytes(c.array) + heapBytes(c.bits);
+    return n;
+}
+
+// VmRSS / VmHWM from /proc/self/status, in kB (0 where unavailable)
+long procStatusKb(const string &field) {
+    ifstream in("/proc/self/status");
+    string line;
+    while (getline(in, line))
+        if (line.rfind(field + ":", 0) == 0) return atol(line.c_str() + field.size() + 1);
+    return 0;
+}
+
+long rssBeforeInitKb = 0, rssAfterInitKb = 0, peakAfterInitKb = 0;
+
+struct MemLine {
+    size_t bytes = 0, slack = 0, count = 0;
+    void add(size_t b, size_t sl = 0, size_t c = 1) {
+        bytes += b;
+        slack += sl;
+        count += c;
+    }
+};
+
+void printMemStats() {
+    auto kb = [](long long b) {
+        ostringstream o;
+        o << fixed << setprecision(1) << b / 1024.0 << " KB";
+        return o.str();
+    };
+
+    if (memTracking) {
+        cout << "Heap by allocating stage (live / peak / allocations / frees / malloc overhead):" << endl;
+        long long totalLive = 0, blocks = 0;
+        for (int c = 0; c < MemCategoryCount; ++c) {
+            const MemCounters &m = memCounters[c];
+            totalLive += m.live;
+            blocks += m.allocs - m.frees;
+            cout << "  " << left << setw(18) << memCategoryNames[c] << right << setw(11) << kb(m.live) << setw(11)
+                 << kb(m.peak) << setw(9) << m.allocs << setw(9) << m.frees << setw(11) << kb(m.overhead) << endl;
+        }
+        cout << "  " << left << setw(18) << "total" << right << setw(11) << kb(totalLive) << endl;
+        cout << "  (tracking headers add " << kb(blocks * (long long)sizeof(AllocHeader))
+             << " on top, counted in RSS only)" << endl;
+    } else {
+        cout << "Heap by allocating stage: not tracked in this build (compile with -DROADMAP_TRACK_ALLOC)." << endl;
+    }
+
+    // what the structures hold now, whichever stage allocated it
+    MemLine keys, names, titles, stepLists, steps, buckets, terms, related, graph;
+    MemLine dedupIndex, tenantDeltas, tenantIndexes, tenantSteps, progressMap;
+    for (auto &kv : roadmaps) {
+        keys.add(heapBytes(kv.first), slackBytes(kv.first));
+        keys.add(heapBytes(kv.second.prerequisites), slackBytes(kv.second.prerequisites), 0);
+        for (auto &pre : kv.second.prerequisites) keys.add(heapBytes(pre), slackBytes(pre), 0);
+        names.add(heapBytes(kv.second.displayName) + heapBytes(kv.second.searchName),
+                  slackBytes(kv.second.displayName) + slackBytes(kv.second.searchName), 2);
+        stepLists.add(heapBytes(kv.second.phases), slackBytes(kv.second.phases), 0);
+        for (auto &p : kv.second.phases) {
+            titles.add(heapBytes(p.title), slackBytes(p.title));
+            stepLists.add(heapBytes(p.steps), slackBytes(p.steps));
+        }
+    }
+    steps.add(heapBytes(stepTexts), slackBytes(stepTexts), 0);
+    for (auto &t : stepTexts) steps.add(heapBytes(t), slackBytes(t));
+    buckets.add(hashMapBytes(roadmaps), 0, roadmaps.bucket_count());
+    terms.add(hashMapBytes(termIndex) + heapBytes(roleKeys), 0, termIndex.size());
+    for (auto &kv : termIndex) terms.add(heapBytes(kv.first) + heapBytes(kv.second), 0, 0);
+    for (auto &k : roleKeys) terms.add(heapBytes(k), 0, 0);
+    const RelatedIndex &ri = relatedIndex;
+    related.add(hashMapBytes(ri.termIds) + heapBytes(ri.df) + hashMapBytes(ri.counts) + heapBytes(ri.vecStart) +
+                    heapBytes(ri.vecTerm) + heapBytes(ri.vecWeight) + heapBytes(ri.postStart) + heapBytes(ri.postRole) +
+                    heapBytes(ri.postWeight),
+                0, ri.vecTerm.size());
+    for (auto &kv : ri.termIds) related.add(heapBytes(kv.first), 0, 0);
+    for (auto &c : ri.counts) related.add(heapBytes(c.first) + heapBytes(c.second), slackBytes(c.second), 0);
+    const SkillGraph &g = skillGraph;
+    graph.add(heapBytes(g.phaseBase) + heapBytes(g.outStart) + heapBytes(g.outAdj) + heapBytes(g.inStart) +
+                  heapBytes(g.inAdj) + heapBytes(g.topoRank),
+              0, g.outAdj.size());
+    dedupIndex.add(heapBytes(stepDedup.poolBands), slackBytes(stepDedup.poolBands), stepDedup.poolBands.size());
+    dedupIndex.add(heapBytes(stepDedup.sample), slackBytes(stepDedup.sample), 0);
+    for (auto &m : stepDedup.sample) dedupIndex.add(heapBytes(m.first), slackBytes(m.first), 0);
+
+    // tenants: deltas (items = role changes), derived bitmaps and posting
+    // caches (items = cached terms), and the steps only tenants use
+    auto phaseBytes = [](const Phase &p) { return heapBytes(p.title) + heapBytes(p.steps); };
+    for (auto &tk : tenants) {
+        const TenantOverlay &t = tk.second;
+        tenantDeltas.add(heapBytes(tk.first) + heapBytes(t.name) + treeBytes(t.roles) + heapBytes(t.addedKeys), 0, 0);
+        for (auto &k : t.addedKeys) tenantDeltas.add(heapBytes(k), 0, 0);
+        for (auto &rd : t.roles) {
+            const RoleDelta &d = rd.second;
+            tenantDeltas.add(heapBytes(rd.first) + heapBytes(d.displayName) + treeBytes(d.replacedPhases) +
+                             treeBytes(d.removedPhases) + heapBytes(d.appendedPhases));
+            for (auto &rp : d.replacedPhases) tenantDeltas.add(phaseBytes(rp.second), 0, 0);
+            for (auto &p : d.appendedPhases) tenantDeltas.add(phaseBytes(p), 0, 0);
+        }
+        tenantIndexes.add(heapBytes(t.changed) + heapBytes(t.visible) + hashMapBytes(t.terms) + hashMapBytes(t.merged), 0, 0);
+        for (auto &kv : t.terms) tenantIndexes.add(heapBytes(kv.first) + heapBytes(kv.second), 0, 0);
+        for (auto &kv : t.merged) tenantIndexes.add(heapBytes(kv.first) + heapBytes(kv.second));
+    }
+    tenantSteps.add(heapBytes(tenantStepTexts) + hashMapBytes(tenantStepIds), slackBytes(tenantStepTexts), 0);
+    for (auto &t : tenantStepTexts) tenantSteps.add(heapBytes(t), slackBytes(t));
+
+    // mapped file, not heap; unused capacity = empty slots
+    if (progressStore.base)
+        progressMap.add(progressStore.size,
+                        (progressStore.header()->capacity - progressStore.header()->used) * sizeof(ProgressStore::Slot),
+                        progressStore.header()->used);
+
+    cout << "\nCatalog structures, indexes and caches (heap bytes / unused capacity / items):" << endl;
+    pair<const char *, MemLine *> lines[] = {
+        {"keys", &keys},          {"display names", &names}, {"phase titles", &titles},
+        {"step texts", &steps},   {"step id lists", &stepLists}, {"map buckets+nodes", &buckets},
+        {"term index", &terms},   {"related index", &related}, {"skill graph", &graph},
+        {"dedup band index", &dedupIndex}, {"tenant deltas", &tenantDeltas}, {"tenant indexes", &tenantIndexes},
+        {"tenant steps", &tenantSteps}, {"progress (mapped)", &progressMap}};
+    for (auto &l : lines)
+        cout << "  " << left << setw(18) << l.first << right << setw(11) << kb(l.second->bytes) << setw(11)
+             << kb(l.second->slack) << setw(9) << l.second->count << endl;
+
+    cout << "\nPer role (structure / step text referenced):" << endl;
+    for (auto &key : sortedKeys()) {
+        const Roadmap &r = roadmaps[key];
+        size_t own = heapBytes(key) + heapBytes(r.displayName) + heapBytes(r.searchName) + heapBytes(r.phases), text = 0;
+        for (auto &p : r.phases) {
+            own += heapBytes(p.title) + heapBytes(p.steps);
+            for (uint32_t id : p.steps) text += stepTexts[id].size();
+        }
+        cout << "  " << left << setw(26) << r.displayName << right << setw(11) << kb(own) << setw(11) << kb(text) << endl;
+    }
+
+    cout << "\nRSS: " << rssBeforeInitKb << " kB before initRoadmaps(), " << rssAfterInitKb << " kB after; peak "
+         << peakAfterInitKb << " kB by the end of loading, " << procStatusKb("VmHWM") << " kB now." << endl;
+}
+
+// Stages of the catalog build that run after the roadmaps are merged.
+// changedKeys are the roles that were added or replaced: the related-roles
+// index only re-counts those, the others are rebuilt because role IDs move.
+void buildIndexes(const vector<string> &changedKeys) {
+    buildTermIndex();
+    buildRelatedIndex(changedKeys);
+    skillGraph.build();
+    for (auto &kv : tenants) kv.second.buildIndex(); // their role IDs follow the base
+}
+
+// ---------------- catalog import ----------------
+
+// Adds roles from a file to the base catalog, replacing roles with the same
+// key. One directive per line, '#' starts a comment:
+//   role <name>      start a role
+//   phase <TITLE>    start a phase of that role
+//   step <text>
+//   requires <role>  the role builds on another role (repeatable)
+// The roles go through buildCatalog(), so only they are re-counted by the
+// incremental index stages.
+bool importRoles(const string &file) {
+    ifstream in(file);
+    if (!in) {
+        cout << "Cannot read '" << file << "'." << endl;
+        return false;
+    }
+    MemScope scope(MemDefinitions);
+    vector<RoleDef> defs;
+    string line;
+    int lineNo = 0;
+    while (getline(in, line)) {
+        ++lineNo;
+        vector<string> words = splitWords(line);
+        if (words.empty() || words[0][0] == '#') continue;
+        string op = normalize(words[0]), arg = restOf(line, 1);
+        string error;
+        if (arg.empty()) error = op + " needs text";
+        else if (op == "role") defs.push_back(RoleDef{arg, {}, {}});
+        else if (op == "phase" && !defs.empty()) defs.back().phases.push_back(PhaseDef{arg, {}});
+        else if (op == "step" && !defs.empty() && !defs.back().phases.empty()) defs.back().phases.back().steps.push_back(arg);
+        else if (op == "requires" && !defs.empty()) defs.back().prerequisites.push_back(arg);
+        else error = op == "phase" || op == "step" || op == "requires" ? op + " outside a role/phase" : "unknown directive '" + words[0] + "'";
+        if (!error.empty()) {
+            cout << file << ":" << lineNo << ": " << error << endl;
+            return false;
+        }
+    }
+    size_t n = defs.size();
+    buildCatalog(defs);
+    cout << "Imported " << n << " role" << (n == 1 ? "" : "s") << " (" << roadmaps.size() << " in the catalog)." << endl;
+    return true;
+}
+
+// ---------------- build benchmark ----------------
+
+// Builds a synthetic catalog of `roles` roles (the built-in roles repeated,
+// each copy renamed and its steps tagged so texts differ) with 1, 2, 4, ...
+// up to maxThreads threads and prints the time of each build stage. The
+// catalog is replaced, so this is only offered as a start-up flag.
+void benchBuild(size_t roles, size_t maxThreads) {
+    vector<RoleDef> base = builtinRoles();
+    cout << "Building " << roles << " synthetic roles (" << thread::hardware_concurrency()
+         << " hardware threads), times in ms:" << endl;
+    cout << setw(8) << "threads" << setw(10) << "prepare" << setw(10) << "dedup" << setw(10) << "merge"
+         << setw(10) << "indexes" << setw(10) << "total" << setw(9) << "speedup" << setw(8) << "steps" << endl;
+    double first = 0;
+    for (size_t t = 1;; t = min(t * 2, maxThreads)) {
+        vector<RoleDef> defs;
+        defs.reserve(roles);
+        for (size_t i = 0; i < roles; ++i) {
+            RoleDef d = base[i % base.size()];
+            d.name += " " + to_string(i);
+            for (auto &p : d.phases)
+                for (auto &st : p.steps) st += " (track " + to_string(i) + ")";
+            defs.push_back(move(d));
+        }
+        roadmaps.clear();
+        stepTexts.clear();
+        stepDedup = StepDedup{}; // its pool index refers to stepTexts
+        relatedIndex = RelatedIndex{};
+        threadLimit = t;
+        auto t0 = chrono::steady_clock::now();
+        buildCatalog(defs);
+        double total = msSince(t0);
+        if (t == 1) first = total;
+        const BuildTimings &bt = buildTimings;
+        cout << fixed << setprecision(1) << setw(8) << t << setw(10) << bt.prepare << setw(10) << bt.dedup << setw(10)
+             << bt.merge << setw(10) << bt.indexes << setw(10) << total << setw(8) << setprecision(2) << first / total
+             << "x" << setw(8) << stepTexts.size() << endl;
+        cout.unsetf(ios::fixed);
+        if (t >= maxThreads) break;
+    }
+    threadLimit = 0;
+}
+
+// ---------------- commands ----------------
+
+// Handles the non-lookup commands. Returns false if the line is not one of them,
+// in which case it is treated as a role name.
+bool handleCommand(const string &line) {
+    vector<string> args = splitWords(line);
+    if (args.empty()) return false;
+    string cmd = normalize(args[0]);
+
+    if (cmd == "export") {
+        string dir = "site";
+        Format f = Format::Html;
+        for (size_t i = 1; i < args.size(); ++i) {
+            if (args[i] == "--out" && i + 1 < args.size()) {
+                dir = args[++i];
+            } else if (args[i] == "--format" && i + 1 < args.size()) {
+                string v = normalize(args[++i]);
+                if (v == "html") f = Format::Html;
+                else if (v == "md" || v == "markdown") f = Format::Markdown;
+                else {
+                    cout << "Unknown format '" << v << "' (use html or md)." << endl;
+                    return true;
+                }
+            } else {
+                cout << "Usage: export --out <dir> --format html|md" << endl;
+                return true;
+            }
+        }
+        exportCatalog(dir, f);
+        return true;
+    }
+
+    if (cmd == "filter") {
+        string expr = restOf(line, 1);
+        if (expr.empty()) {
+            cout << "Usage: filter <expr>, e.g. filter docker AND kubernetes AND NOT terraform, filter title:testing" << endl;
+            return true;
+        }
+        FilterParser parser(expr);
+        if (currentTenant) {
+            parser.universe = &currentTenant->visible;
+            parser.posting = [](const string &term) { return currentTenant->posting(term); };
+        }
+        RoleBitmap result = parser.parseExpr();
+        if (parser.error.empty() && parser.pos < parser.toks.size()) parser.error = "unexpected '" + parser.toks[parser.pos] + "'";
+        if (!parser.error.empty()) {
+            cout << "Bad filter: " << parser.error << "." << endl;
+            return true;
+        }
+        vector<string> names;
+        result.forEach([&](uint32_t id) {
+            names.push_back(currentTenant ? resolveRole(currentTenant->keyOfId(id)).displayName : roadmaps[roleKeys[id]].displayName);
+        });
+        cout << names.size() << " matching role" << (names.size() == 1 ? "" : "s") << (names.empty() ? "." : ":") << endl;
+        for (auto &n : names) cout << " - " << n << endl;
+        return true;
+    }
+
+    if (cmd == "done" || cmd == "undo") {
+        // done <user> <role...> <phase>.<step>
+        if (args.size() < 4) {
+            cout << "Usage: " << cmd << " <user> <role> <phase>.<step>   (numbers as shown in the roadmap)" << endl;
+            return true;
+        }
+        string role;
+        for (size_t i = 2; i + 1 < args.size(); ++i) role += (role.empty() ? "" : " ") + args[i];
+        vector<string> matches = lookupRoles(role);
+        if (matches.size() != 1) {
+            cout << (matches.empty() ? "No roadmap found for '" : "Role is ambiguous: '") << role << "'." << endl;
+            return true;
+        }
+        Roadmap r = resolveRole(matches[0]);
+        string slot = progressKey(matches[0]);
+        long idx = stepIndex(r, args.back());
+        if (idx < 0) {
+            cout << "No step " << args.back() << " in " << r.displayName << "." << endl;
+            return true;
+        }
+        if (stepCount(r) > ProgressStore::kMaxSteps) {
+            cout << r.displayName << " has more steps than progress tracking supports." << endl;
+            return true;
+        }
+        if (!openProgress()) return true;
+        if (!progressStore.mark(args[1], slot, r, (size_t)idx, cmd == "done")) {
+            cout << "Could not update progress." << endl;
+            return true;
+        }
+        const ProgressStore::Slot *s = progressStore.get(args[1], slot, r);
+        size_t total = stepCount(r), done = countDone(*s, 0, total);
+        cout << r.displayName << ": " << done << "/" << total << " steps done (" << percent(done, total) << ")." << endl;
+        return true;
+    }
+
+    if (cmd == "progress") {
+        // progress <user> [role...]
+        if (args.size() < 2) {
+            cout << "Usage: progress <user> [role]" << endl;
+            return true;
+        }
+        if (!openProgress()) return true;
+        const string &user = args[1];
+        if (args.size() > 2) {
+            string role;
+            for (size_t i = 2; i < args.size(); ++i) role += (role.empty() ? "" : " ") + args[i];
+            vector<string> matches = lookupRoles(role);
+            if (matches.size() != 1) {
+                cout << (matches.empty() ? "No roadmap found for '" : "Role is ambiguous: '") << role << "'." << endl;
+                return true;
+            }
+            Roadmap r = resolveRole(matches[0]);
+            const ProgressStore::Slot *s = progressStore.get(user, progressKey(matches[0]), r);
+            size_t total = stepCount(r), done = s ? countDone(*s, 0, total) : 0;
+            cout << r.displayName << ": " << done << "/" << total << " steps done (" << percent(done, total) << ")" << endl;
+            size_t begin = 0;
+            int pidx = 1;
+            for (auto &p : r.phases) {
+                size_t end = begin + p.steps.size(), pd = s ? countDone(*s, begin, end) : 0;
+                cout << "  PHASE " << pidx++ << " — " << p.title << ": " << pd << "/" << p.steps.size() << endl;
+                begin = end;
+            }
+            return true;
+        }
+        size_t allDone = 0, allTotal = 0;
+        vector<string> keys = roleKeys;
+        if (currentTenant) {
+            keys.clear();
+            currentTenant->forEachRole([&](const string &key, const Roadmap &) { keys.push_back(key); });
+            sort(keys.begin(), keys.end());
+        }
+        Roadmap scratch;
+        for (auto &key : keys) {
+            const Roadmap &r = viewRole(key, scratch);
+            const ProgressStore::Slot *s = progressStore.get(user, progressKey(key), r);
+            if (!s) continue;
+            size_t total = stepCount(r), done = countDone(*s, 0, total);
+            if (!done) continue;
+            allDone += done;
+            allTotal += total;
+            cout << " - " << r.displayName << ": " << done << "/" << total << " (" << percent(done, total) << ")" << endl;
+        }
+        if (!allTotal) cout << "No progress recorded for '" << user << "'." << endl;
+        else cout << "Overall: " << allDone << "/" << allTotal << " steps in started roadmaps (" << percent(allDone, allTotal) << ")." << endl;
+        return true;
+    }
+
+    if (cmd == "related") {
+        if (args.size() < 2) {
+            cout << "Usage: related <role>" << endl;
+            return true;
+        }
+        string role = restOf(line, 1);
+        vector<string> matches = lookupRoles(role);
+        if (matches.size() != 1) {
+            cout << (matches.empty() ? "No roadmap found for '" : "Role is ambiguous: '") << role << "'." << endl;
+            return true;
+        }
+        // vectors exist for base content only
+        const string &key = matches[0];
+        int id = roleIdOf(key);
+        if (id < 0 || (currentTenant && currentTenant->roles.count(key))) {
+            cout << "No related-roles vector for " << resolveRole(key).displayName << ": it was "
+                 << (id < 0 ? "added" : "edited") << " by tenant '" << currentTenant->name
+                 << "', and related roles are computed from the base catalog only." << endl;
+            return true;
+        }
+        size_t hidden = 0;
+        if (currentTenant)
+            for (auto &rd : currentTenant->roles) hidden += rd.second.removed;
+        auto top = relatedIndex.topK((uint32_t)id, 5 + hidden);
+        if (currentTenant)
+            top.erase(remove_if(top.begin(), top.end(), [](auto &rs) { return currentTenant->hides(roleKeys[rs.first]); }),
+                      top.end());
+        top.resize(min<size_t>(top.size(), 5));
+        cout << "Roles closest to " << roadmaps[key].displayName << ":" << endl;
+        for (auto &rs : top)
+            cout << " - " << resolveRole(roleKeys[rs.first]).displayName << " (" << fixed << setprecision(2) << rs.second << ")" << endl;
+        cout.unsetf(ios::fixed);
+        if (top.empty()) cout << " (none)" << endl;
+        return true;
+    }
+
+    if (cmd == "dedup") {
+        const StepDedup &d = stepDedup;
+        size_t folded = d.inputSteps - d.storedSteps;
+        cout << d.inputSteps << " steps stored as " << d.storedSteps << " unique steps (" << folded << " deduplicated, "
+             << percent(folded, d.inputSteps, 1) << "); step text " << d.inputBytes << " -> " << d.storedBytes
+             << " bytes." << endl;
+        if (d.mergedSteps)
+            cout << d.mergedSteps << " near-duplicate" << (d.mergedSteps == 1 ? "" : "s") << " folded into a shared step"
+                 << (d.mergedSteps > d.sample.size() ? ", first " + to_string(d.sample.size()) + ":" : ":") << endl;
+        for (auto &m : d.sample) cout << " - \"" << m.first << "\"\n   -> \"" << stepTexts[m.second] << "\"" << endl;
+        return true;
+    }
+
+    if (cmd == "shared") {
+        // shared <role>, <role>
+        string rest = restOf(line, 1);
+        size_t comma = rest.find(',');
+        if (comma == string::npos) {
+            cout << "Usage: shared <role>, <role>" << endl;
+            return true;
+        }
+        string names[2] = {rest.substr(0, comma), rest.substr(comma + 1)};
+        string keys[2];
+        for (int i = 0; i < 2; ++i) {
+            vector<string> matches = findMatches(names[i]);
+            if (matches.size() != 1) {
+                cout << (matches.empty() ? "No roadmap found for '" : "Role is ambiguous: '") << normalize(names[i]) << "'." << endl;
+                return true;
+            }
+            keys[i] = matches[0];
+        }
+        auto stepSet = [](const Roadmap &r) {
+            vector<uint32_t> ids;
+            for (auto &p : r.phases) ids.insert(ids.end(), p.steps.begin(), p.steps.end());
+            sort(ids.begin(), ids.end());
+            ids.erase(unique(ids.begin(), ids.end()), ids.end());
+            return ids;
+        };
+        vector<uint32_t> a = stepSet(roadmaps[keys[0]]), b = stepSet(roadmaps[keys[1]]), both;
+        set_intersection(a.begin(), a.end(), b.begin(), b.end(), back_inserter(both));
+        cout << both.size() << " shared step" << (both.size() == 1 ? "" : "s") << " between "
+             << roadmaps[keys[0]].displayName << " and " << roadmaps[keys[1]].displayName << (both.empty() ? "." : ":") << endl;
+        for (uint32_t id : both) cout << " - " << stepTexts[id] << endl;
+
+        // Paraphrases are too far apart for StepDedup to merge safely, so
+        // they are only listed: remaining steps whose content words overlap
+        // by at least kMinWordOverlap (Jaccard), best first.
+        const double kMinWordOverlap = 0.2;
+        auto contentWords = [](uint32_t id) {
+            vector<string> w;
+            for (auto &t : tokenize(stepTexts[id]))
+                if (!isStopword(t)) w.push_back(t);
+            sort(w.begin(), w.end());
+            w.erase(unique(w.begin(), w.end()), w.end());
+            return w;
+        };
+        vector<uint32_t> onlyA, onlyB;
+        set_difference(a.begin(), a.end(), both.begin(), both.end(), back_inserter(onlyA));
+        set_difference(b.begin(), b.end(), both.begin(), both.end(), back_inserter(onlyB));
+        vector<vector<string>> wordsB;
+        for (uint32_t id : onlyB) wordsB.push_back(contentWords(id));
+        vector<tuple<double, uint32_t, uint32_t>> similar;
+        for (uint32_t ida : onlyA) {
+            vector<string> wa = contentWords(ida), common;
+            for (size_t j = 0; j < onlyB.size(); ++j) {
+                common.clear();
+                set_intersection(wa.begin(), wa.end(), wordsB[j].begin(), wordsB[j].end(), back_inserter(common));
+                size_t all = wa.size() + wordsB[j].size() - common.size();
+                double score = all ? (double)common.size() / all : 0;
+                if (score >= kMinWordOverlap) similar.emplace_back(score, ida, onlyB[j]);
+            }
+        }
+        sort(similar.begin(), similar.end(), [](auto &x, auto &y) { return get<0>(x) > get<0>(y); });
+        if (!similar.empty()) cout << "Similar steps (not merged; word overlap):" << endl;
+        for (auto &sm : similar)
+            cout << " - (" << fixed << setprecision(2) << get<0>(sm) << ") " << stepTexts[get<1>(sm)] << "\n   ~ "
+                 << stepTexts[get<2>(sm)] << endl;
+        cout.unsetf(ios::fixed);
+        return true;
+    }
+
+    if (cmd == "path") {
+        // path <from> <to>; use a comma when a role name has spaces
+        string rest = restOf(line, 1);
+        size_t comma = rest.find(',');
+        string names[2];
+        if (comma != string::npos) {
+            names[0] = rest.substr(0, comma);
+            names[1] = rest.substr(comma + 1);
+        } else if (args.size() == 3) {
+            names[0] = args[1];
+            names[1] = args[2];
+        } else {
+            cout << "Usage: path <from> <to>   or   path <from role>, <to role>" << endl;
+            return true;
+        }
+        int ids[2];
+        for (int i = 0; i < 2; ++i) {
+            vector<string> matches = findMatches(names[i]);
+            if (matches.size() != 1) {
+                cout << (matches.empty() ? "No roadmap found for '" : "Role is ambiguous: '") << normalize(names[i]) << "'." << endl;
+                return true;
+            }
+            ids[i] = roleIdOf(matches[0]);
+        }
+        const string &fromName = roadmaps[roleKeys[ids[0]]].displayName, &toName = roadmaps[roleKeys[ids[1]]].displayName;
+        vector<uint32_t> steps = skillGraph.delta((uint32_t)ids[0], (uint32_t)ids[1]);
+        cout << "Knowing " << fromName << ", " << steps.size() << " more step" << (steps.size() == 1 ? "" : "s")
+             << " to reach " << toName << (steps.empty() ? "." : ":") << endl;
+        // label each step with the first role on the way (target first) that lists it
+        unordered_map<uint32_t, string> phaseOf;
+        for (uint32_t role : SkillGraph::withPrerequisites((uint32_t)ids[1])) {
+            const Roadmap &r = roadmaps[roleKeys[role]];
+            for (auto &p : r.phases)
+                for (uint32_t st : p.steps) phaseOf.emplace(st, r.displayName + " / " + p.title);
+        }
+        for (uint32_t st : steps) cout << " - [" << phaseOf[st] << "] " << stepTexts[st] << endl;
+        return true;
+    }
+
+    if (cmd == "tenant") {
+        // tenant | tenant load <name> <file> | tenant use <name> | tenant none
+        string sub = args.size() > 1 ? normalize(args[1]) : "";
+        if (sub == "load" && args.size() == 4) {
+            if (loadTenant(args[2], args[3])) {
+                const TenantOverlay &t = tenants[args[2]];
+                cout << "Loaded tenant '" << args[2] << "': " << t.roles.size() << " role change"
+                     << (t.roles.size() == 1 ? "" : "s") << "." << endl;
+            }
+        } else if (sub == "use" && args.size() == 3) {
+            auto it = tenants.find(args[2]);
+            if (it == tenants.end()) cout << "No tenant '" << args[2] << "'. Load it with: tenant load <name> <file>" << endl;
+            else {
+                currentTenant = &it->second;
+                cout << "Now viewing the catalog as tenant '" << args[2] << "'." << endl;
+            }
+        } else if (sub == "none" && args.size() == 2) {
+            currentTenant = nullptr;
+            cout << "Now viewing the base catalog." << endl;
+        } else if (args.size() == 1) {
+            cout << "Current: " << (currentTenant ? currentTenant->name : "(base catalog)") << endl;
+            for (auto &kv : tenants) cout << " - " << kv.first << " (" << kv.second.roles.size() << " role changes)" << endl;
+        } else {
+            cout << "Usage: tenant [load <name> <file> | use <name> | none]" << endl;
+        }
+        return true;
+    }
+
+    if (cmd == "import") {
+        if (args.size() != 2) cout << "Usage: import <file>" << endl;
+        else importRoles(args[1]);
+        return true;
+    }
+
+    if (cmd == "memstats") {
+        printMemStats();
+        return true;
+    }
+
+    if (cmd == "find") {
+        activeHighlight.reset();
+        if (args.size() < 2) {
+            cout << "Highlighting cleared. Usage: find <keyword> [keyword...]" << endl;
+            return true;
+        }
+        auto m = make_unique<KeywordMatcher>(vector<string>(args.begin() + 1, args.end()));
+        if (m->empty()) return true;
+
+        // one pass per step; roles ordered by total hits, then name
+        struct RoleHits { string key; int total; vector<int> hits; vector<string> lines; };
+        vector<RoleHits> found;
+        for (auto &key : sortedKeys()) {
+            const Roadmap &r = roadmaps[key];
+            RoleHits rh{key, 0, vector<int>(m->terms.size(), 0), {}};
+            int pidx = 1;
+            for (auto &p : r.phases) {
+                int sidx = 1;
+                for (uint32_t id : p.steps) {
+                    int before = accumulate(rh.hits.begin(), rh.hits.end(), 0);
+                    ostringstream line;
+                    renderStep(line, stepTexts[id], Format::Text, m.get(), &rh.hits);
+                    if (accumulate(rh.hits.begin(), rh.hits.end(), 0) > before)
+                        rh.lines.push_back(to_string(pidx) + "." + to_string(sidx) + " " + line.str());
+                    ++sidx;
+                }
+                ++pidx;
+            }
+            rh.total = accumulate(rh.hits.begin(), rh.hits.end(), 0);
+            if (rh.total) found.push_back(move(rh));
+        }
+        stable_sort(found.begin(), found.end(), [](const RoleHits &a, const RoleHits &b) { return a.total > b.total; });
+
+        if (found.empty()) {
+            cout << "No steps mention those keywords." << endl;
+            return true;
+        }
+        for (auto &rh : found) {
+            cout << "\n" << roadmaps[rh.key].displayName << " — " << rh.total << " hit" << (rh.total == 1 ? "" : "s")
+                 << " (" << hitSummary(*m, rh.hits) << ")" << endl;
+            for (auto &l : rh.lines) cout << "  " << l << endl;
+        }
+        activeHighlight = move(m);
+        cout << "\nRoadmaps you open now highlight these keywords ('find' alone clears)." << endl;
+        return true;
+    }
+
+    return false;
+}
+
+
+int main(int argc, char **argv) {
+    ios::sync_with_stdio(false);
+    cin.tie(nullptr);
+
+    // --memstats: print the memory report once the catalog is loaded
+    bool memstats = false;
+    for (int i = 1; i < argc; ++i) {
+        if (string(argv[i]) != "--memstats") continue;
+        memstats = true;
+        copy(argv + i + 1, argv + argc, argv + i);
+        --argc;
+        --i;
+    }
+
+    // --bench-build <roles> [maxThreads]: thread scaling report of the build pipeline
+    if (argc >= 3 && string(argv[1]) == "--bench-build") {
+        long roles = atol(argv[2]);
+        long maxThreads = argc >= 4 ? atol(argv[3]) : (long)thread::hardware_concurrency();
+        if (roles < 1 || maxThreads < 1) {
+            cout << "Usage: --bench-build <roles> [maxThreads]" << endl;
+            return 1;
+        }
+        benchBuild((size_t)roles, (size_t)maxThreads);
+        return 0;
+    }
+
+    rssBeforeInitKb = procStatusKb("VmRSS");
+    initRoadmaps();
+    rssAfterInitKb = procStatusKb("VmRSS");
+    peakAfterInitKb = procStatusKb("VmHWM");
+    if (memstats) printMemStats();
+
+    // one-shot mode: run the command given on the command line and exit
+    if (argc > 1) {
+        string line;
+        for (int i = 1; i < argc; ++i) line += string(i > 1 ? " " : "") + argv[i];
+        if (!handleCommand(line)) {
+            vector<string> matches = findMatches(line);
+            if (matches.empty()) {
+                cout << "No roadmap found for '" << line << "'." << endl;
+                return 1;
+            }
+            for (auto &m : matches) printRoadmap(roadmaps[m]);
+        }
+        return 0;
+    }
+
+    // Print welcome banner with endl for flush
+    cout << "============================================================" << endl;
+    cout << "              ROLE-BASED ROADMAP SEARCH SYSTEM" << endl;
+    cout << "============================================================" << endl << endl;
+
+    cout << "Available Roles:" << endl;
+    cout << "------------------------------------------------------------" << endl;
+    for (auto &kv : roadmaps) {
+        cout << kv.second.displayName << endl;
+    }
+    cout << "------------------------------------------------------------" << endl;
+    cout << "Type any role name to view its FULL roadmap." << endl;
+    cout << "(To exit, type: exit)" << endl << endl;
+
+    while (true) {
+        cout << "\nEnter role: " << flush;  // flush ensures prompt is visible immediately
+        string line;
+        if (!getline(cin, line)) break;
+
+        // trim input
+        while (!line.empty() && isspace((unsigned char)line.front())) line.erase(line.begin());
+        while (!line.empty() && isspace((unsigned char)line.back())) line.pop_back();
+        if (line.empty()) continue;
+
+        string lower = normalize(line);
+        if (lower == "exit" || lower == "quit") {
+            cout << "Bye." << endl;
+            break;
+        }
+
+        if (lower == "list") {
+            cout << "\nSupported roles:" << endl;
+            vector<string> names;
+            if (currentTenant) currentTenant->forEachRole([&](const string &, const Roadmap &r) { names.push_back(r.displayName); });
+            else for (auto &kv : roadmaps) names.push_back(kv.second.displayName);
+            sort(names.begin(), names.end());
+            for (auto &n : names) cout << " - " << n << endl;
+            continue;
+        }
+
+        if (handleCommand(line)) continue;
+
+        vector<string> matches = lookupRoles(line);
+        if (matches.empty()) {
+            cout << "No roadmap found for '" << line << "'. Try 'list' to see supported roles or type a substring." << endl;
+            continue;
+        }
+
+        if (matches.size() > 1) {
+            cout << "\nMultiple matches found. Please choose:" << endl;
+            for (size_t i = 0; i < matches.size(); ++i)
+                cout << i + 1 << ") " << resolveRole(matches[i]).displayName << endl;
+            cout << "Enter number (or 0 to cancel): " << flush;
+
+            string numLine;
+            if (!getline(cin, numLine)) break;
+            int choice = 0;
+            try { choice = stoi(numLine); } catch (...) { choice = 0; }
+            if (choice <= 0 || choice > (int)matches.size()) {
+                cout << "Cancelled." << endl;
+                continue;
+            }
+            matches = {matches[choice - 1]};
+        }
+        printRoadmap(resolveRole(matches[0]));
+        string related = viewRelatedLine(matches[0]);
+        if (!related.empty()) cout << related << endl;
     }
 
     return 0;